@@ -0,0 +1,16 @@
+#pragma once
+// Digital actuator outputs, each declared exactly once (pin + polarity).
+#include "config.h"
+#include "hal/out_pin.h"
+
+/** Heater relay input (PIN_HEATER_RELAY, polarity HEATER_ACTIVE_HIGH). */
+using HeaterRelay = Hal::OutPin<PIN_HEATER_RELAY, (HEATER_ACTIVE_HIGH != 0)>;
+
+/** Pump MOSFET gate; held low as a plain output until LEDC takes the pin. */
+using PumpGate = Hal::OutPin<PIN_PUMP, true>;
+
+#if TANK_COUNT > 1
+/** Second tank: same relay module and MOSFET stage, own pins. */
+using Tank1Relay    = Hal::OutPin<TANK1_RELAY_PIN, (HEATER_ACTIVE_HIGH != 0)>;
+using Tank1PumpGate = Hal::OutPin<TANK1_PUMP_PIN, true>;
+#endif
@@ -0,0 +1,116 @@
+// Heater-aware circulation: heating run, mixing run, idle destratification pulses
+#include "circulation.h"
+#include "config.h"
+
+namespace {
+  constexpr float   CURVE_ERR[] = CIRC_CURVE_ERR_C;
+  constexpr uint8_t CURVE_PCT[] = CIRC_CURVE_PCT;
+  constexpr size_t  CURVE_N     = sizeof(CURVE_PCT) / sizeof(CURVE_PCT[0]);
+  static_assert(sizeof(CURVE_ERR) / sizeof(CURVE_ERR[0]) == CURVE_N && CURVE_N >= 1,
+                "CIRC_CURVE_ERR_C and CIRC_CURVE_PCT need the same number of points");
+}
+
+Circulation::Circulation(const char* tank, Pump& pump, float volumeL)
+  : tank_(tank), pump_(pump), turnoverMs_((uint32_t)(volumeL * 3600000.0f / PUMP_FLOW_LPH)) {}
+
+// Enough turnovers to even out the bath, plus a share of the heat just put in
+uint32_t Circulation::mixMs(uint32_t onMs) const {
+  const uint32_t ms = CIRC_MIX_TURNOVERS * turnoverMs_ + onMs / 100 * CIRC_MIX_ON_PCT;
+  return constrain(ms, CIRC_MIX_MIN_MS, CIRC_MIX_MAX_MS);
+}
+
+uint32_t Circulation::pulseMs() const {
+  return max<uint32_t>(CIRC_PULSE_TURNOVERS * turnoverMs_, CIRC_PULSE_MIN_MS);
+}
+
+uint8_t Circulation::levelFor(float errC, bool heaterOn) {
+  float pct = CURVE_PCT[CURVE_N - 1];   // no reading: mix hard
+  if (!isnan(errC)) {
+    pct = CURVE_PCT[0];
+    for (size_t i = 1; i < CURVE_N; ++i) {
+      if (errC <= CURVE_ERR[i - 1]) break;
+      if (errC >= CURVE_ERR[i]) { pct = CURVE_PCT[i]; continue; }
+      const float f = (errC - CURVE_ERR[i - 1]) / (CURVE_ERR[i] - CURVE_ERR[i - 1]);
+      pct = CURVE_PCT[i - 1] + f * (CURVE_PCT[i] - CURVE_PCT[i - 1]);
+      break;
+    }
+  }
+  if (heaterOn) pct = max(pct, (float)CIRC_HEATING_MIN_PCT);
+  const uint8_t q = (uint8_t)(pct / CIRC_LEVEL_STEP_PCT + 0.5f) * CIRC_LEVEL_STEP_PCT;
+  return min<uint8_t>(q, 100);
+}
+
+void Circulation::update(bool heaterOn, bool heaterEnabled, float errC) {
+  const bool edge = heaterOn != heaterOn_;
+  const bool toggled = heaterEnabled != enabled_;
+  heaterOn_ = heaterOn;
+  enabled_  = heaterEnabled;
+  if (mode_ == Mode::Manual) return;
+
+  const uint8_t lvl = levelFor(errC, heaterOn);
+  if (lvl != pump_.level()) pump_.setLevel(lvl);
+  if (!edge && !toggled) return;
+
+  const uint64_t now = Timers::nowMs();
+  if (edge && heaterOn) {
+    heatMs_ = now;
+    enter(Mode::Heating);
+  } else if (edge) {
+    enter(Mode::Mixing, mixMs((uint32_t)(now - heatMs_)));
+  } else if (mode_ == Mode::Idle) {
+    idle();   // pulses start / stop with the heater enable
+  }
+}
+
+void Circulation::toggleManual() {
+  if (mode_ != Mode::Manual) {
+    pump_.setLevel(100);
+    enter(Mode::Manual);
+    return;
+  }
+  if (heaterOn_) enter(Mode::Heating); else idle();
+}
+
+void Circulation::restart() {
+  if (mode_ == Mode::Idle) enter(Mode::Pulse, pulseMs());
+  else pump_.on();
+}
+
+void Circulation::enter(Mode m, uint32_t forMs) {
+  Timers::cancel(timer_);
+  if (m != mode_) {
+    LOGI("[Circ] %s: %s -> %s", tank_, name(mode_), name(m));
+    if (forMs) LOGI(" for %lu s", (unsigned long)(forMs / 1000));
+    LOGI("\n");
+  }
+  mode_ = m;
+  if (m == Mode::Idle) pump_.off(); else pump_.on();
+  if (forMs) timer_ = Timers::after(forMs, expire, this);
+}
+
+// Pump off; the next destratification pulse is due one period later
+void Circulation::idle() {
+  enter(Mode::Idle);
+  if (enabled_) timer_ = Timers::after(CIRC_IDLE_PERIOD_MS, expire, this);
+}
+
+void Circulation::expire(void* self) {
+  Circulation* c = static_cast<Circulation*>(self);
+  c->timer_ = Timers::NONE;
+  if (c->mode_ == Mode::Idle) {
+    c->enter(Mode::Pulse, c->pulseMs());
+  } else {
+    c->idle();   // end of a mixing run or a pulse
+  }
+}
+
+const char* Circulation::name(Mode m) {
+  switch (m) {
+    case Mode::Idle:    return "idle";
+    case Mode::Heating: return "heating";
+    case Mode::Mixing:  return "mixing";
+    case Mode::Pulse:   return "pulse";
+    case Mode::Manual:  return "manual";
+  }
+  return "?";
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <Arduino.h>
+#include "pump.h"
+#include "timers.h"
+
+/**
+ * Circulation policy for one tank's pump, driven by its heater relay.
+ * - Heating: the pump runs whenever the heater is on, so heat leaves the
+ *   element instead of layering around it and the probe sees the bath
+ * - Mixing: after the heater turns off the pump keeps running for a
+ *   computed period: CIRC_MIX_TURNOVERS bath turnovers plus CIRC_MIX_ON_PCT
+ *   of the on-time that just ended, within CIRC_MIX_MIN/MAX_MS
+ * - Idle: while the heater is enabled but off, a destratification pulse of
+ *   CIRC_PULSE_TURNOVERS turnovers every CIRC_IDLE_PERIOD_MS
+ * - Manual: the operator's pump toggle overrides the policy until toggled again
+ * How hard the pump runs follows the heater error through the
+ * CIRC_CURVE_* curve (at least CIRC_HEATING_MIN_PCT while heating, full
+ * speed in manual), passed to Pump::setLevel().
+ * Deadlines live on the timer wheel; update() only reacts to changes.
+ * Loop task only.
+ */
+class Circulation {
+public:
+  enum class Mode : uint8_t { Idle, Heating, Mixing, Pulse, Manual };
+
+  Circulation(const char* tank, Pump& pump, float volumeL);
+
+  /**
+   * Feed the tank's latest snapshot (every loop pass; acts on changes only).
+   * errC = setpoint - bath temperature (NAN without a reading).
+   */
+  void update(bool heaterOn, bool heaterEnabled, float errC);
+
+  /** Agitation level (% of full speed) for a heater error and relay state. */
+  static uint8_t levelFor(float errC, bool heaterOn);
+
+  /** Operator toggle: manual run on, or back to the policy. */
+  void toggleManual();
+
+  /** Apply the current mode to the pump again (e.g. after a trip reset); idle runs a pulse. */
+  void restart();
+
+  Mode     mode() const { return mode_; }
+  uint32_t turnoverMs() const { return turnoverMs_; }
+
+  static const char* name(Mode m);
+
+private:
+  static void expire(void* self);
+  void enter(Mode m, uint32_t forMs = 0);
+  void idle();
+  uint32_t mixMs(uint32_t onMs) const;
+  uint32_t pulseMs() const;
+
+  const char*    tank_;
+  Pump&          pump_;
+  const uint32_t turnoverMs_;
+  Mode           mode_      = Mode::Idle;
+  Timers::Id     timer_     = Timers::NONE;   // end of mixing / pulse, or next pulse
+  uint64_t       heatMs_    = 0;              // heater switched on
+  bool           heaterOn_  = false;
+  bool           enabled_   = false;
+};
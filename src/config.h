@@ -25,17 +25,227 @@
 #endif
 #define TS_DEFAULT_PERIOD_MS  1000
 #define TS_TIMEOUT_MS         1500
+#define TS_POLL_MS              10  // re-check interval once the nominal conversion time passed
+// Bus re-scan backoff while no probe answers (doubles up to the max)
+#define TS_RESCAN_MIN_MS       500
+#define TS_RESCAN_MAX_MS      8000
+// Scratchpad reads per conversion before the reading is dropped (CRC/presence)
+#define TS_READ_RETRIES          3
+// Consecutive failed conversions before the probe is declared lost
+#define TS_MAX_FAILS             3
+// Optional second DS18B20 in the bath on its own pin, cross-checked by the
+// ThermalGuard (tank 0; TANK1_TS_CHECK_PIN for tank 1). -1 = none
+#ifndef TS_CHECK_PIN
+  #define TS_CHECK_PIN          -1
+#endif
+// Optional DS18B20 clamped to the heater sheath (TANK1_TS_SHEATH_PIN for
+// tank 1): the heater then runs in cascade on it (CASCADE_*). -1 = none
+#ifndef TS_SHEATH_PIN
+  #define TS_SHEATH_PIN         -1
+#endif
 
 /* ----------------- Heater relay hardware ----------------- */
 #ifndef PIN_HEATER_RELAY
   #define PIN_HEATER_RELAY 26
 #endif
-// Set to 1 if relay is ON with HIGH, 0 if ON with LOW
+// Set to 1 if relay is ON with HIGH, 0 if ON with LOW (board: active-LOW).
+// Single source for the HeaterRelay type in actuators.h.
 #ifndef HEATER_ACTIVE_HIGH
-  #define HEATER_ACTIVE_HIGH 1
+  #define HEATER_ACTIVE_HIGH 0
+#endif
+
+/* ----------------- Pump ----------------- */
+// MOSFET gate (100 Ω gate + 100 kΩ pull-down); LEDC ch 0/1 share timer 0
+#ifndef PIN_PUMP
+  #define PIN_PUMP 25
+#endif
+#define PUMP_LEDC_CH 0
+// Tach (FG, open collector, 10 kΩ pull-up to 3V3) on a PCNT unit for the
+// speed loop; -1 = no tach, the pump runs open loop at full duty.
+// The FG ground must not be the PWM-switched pump ground.
+#ifndef PIN_PUMP_TACH
+  #define PIN_PUMP_TACH        -1     // e.g. 34 (input-only, external pull-up)
+#endif
+#define PUMP_PCNT_UNIT         1      // unit 0 = encoder
+#ifndef PUMP_TACH_PPR
+  #define PUMP_TACH_PPR        2      // FG pulses per revolution
+#endif
+#ifndef PUMP_TARGET_RPM
+  #define PUMP_TARGET_RPM      3600
+#endif
+#ifndef PUMP_RPM_FULL
+  #define PUMP_RPM_FULL        4500   // clean pump at full duty in warm etchant (flow health reference)
+#endif
+#define PUMP_TACH_SAMPLE_MS    100    // speed loop period
+#define PUMP_RPM_WINDOW        5      // samples in the RPM moving sum (1..8)
+#define PUMP_TACH_FILTER       1000   // PCNT glitch filter, APB cycles
+#define PUMP_SPINUP_MS         800    // full duty before the speed loop takes over
+#define PUMP_KP                0.02f  // duty per RPM of error change
+#define PUMP_KI                0.04f  // duty per RPM of error per second
+#define PUMP_DUTY_MIN          60     // speed loop floor; lower duty may stall the motor
+#define PUMP_RPM_TOL_PCT       10     // below target by more than this at full duty = saturated
+#define PUMP_LOAD_HIGH_PCT     140    // duty needed vs a clean pump: labored above
+#define PUMP_LOAD_LOW_PCT      70     // and unloaded (dry / blocked) below
+#define PUMP_FAULT_MS          2000   // flow state held this long before it is reported
+#define PUMP_RAMP_STEP_MS      20     // open-loop level changes: one LEDC step per period ...
+#define PUMP_RAMP_COUNTS       2      // ... of this many duty counts (~100 counts/s)
+// Supply current monitor (PumpCurrent): shunt amplifier or hall sensor in
+// the pump's 24 V feed, RC-filtered well below the 20 kHz PWM, on an ADC1
+// pin. Sampled by the I2S ADC DMA while the pump runs; one pump per station.
+#ifndef PIN_PUMP_ISENSE
+  #define PIN_PUMP_ISENSE      -1     // e.g. 36 (SENSOR_VP, ADC1 only); -1 = no monitor
+#endif
+#ifndef PUMP_ISENSE_TANK
+  #define PUMP_ISENSE_TANK     0      // tank whose pump is monitored
+#endif
+#ifndef PUMP_ISENSE_MV_PER_A
+  #define PUMP_ISENSE_MV_PER_A 1000   // 50 mΩ shunt x 20 (INA180A1)
+#endif
+#ifndef PUMP_ISENSE_NOMINAL_MA
+  #define PUMP_ISENSE_NOMINAL_MA 1100 // clean pump, full speed, in etchant
+#endif
+#define PUMP_ISENSE_IDLE_MA    40     // driver electronics, motor unloaded
+#define PUMP_ISENSE_RATE_HZ    10000  // ADC sample rate
+#define PUMP_ISENSE_WINDOW_MS  20     // one DMA buffer = one analysis window
+#define PUMP_ISENSE_BLANK_MS   600    // inrush + spin-up after start, not judged
+#define PUMP_ISENSE_STALL_MA   2500   // locked rotor (or jammed impeller)
+#define PUMP_ISENSE_OPEN_MA    15     // driven but no current: driver lock-out
+#define PUMP_ISENSE_DRY_PCT    55     // load vs a clean pump below this, smooth = dry
+#define PUMP_ISENSE_CLOG_PCT   85     // load below this with ripple = starved inlet
+#define PUMP_ISENSE_RIPPLE_PCT 25     // AC RMS vs mean: cavitation above this
+#define PUMP_ISENSE_TRIP_MS    240    // consecutive bad windows before the drive is cut
+#define PUMP_ISENSE_TASK_PRIO  4      // below the control task
+#define PUMP_ISENSE_TASK_STACK 3072
+#define PUMP_ISENSE_TASK_CORE  0
+
+/* ----------------- Circulation ----------------- */
+// Pump vs heater per tank (Circulation): on while the heater is on, then a
+// mixing run, and destratification pulses while the bath is held idle.
+// Run lengths are in bath turnovers (volume / effective pump flow).
+#ifndef TANK_VOLUME_L
+  #define TANK_VOLUME_L        2.0f   // etchant in tank 0
+#endif
+#ifndef PUMP_FLOW_LPH
+  #define PUMP_FLOW_LPH        400    // effective through tubing and nozzle (pump rated ~800 L/h)
+#endif
+#define CIRC_MIX_TURNOVERS     3      // after the heater turns off ...
+#define CIRC_MIX_ON_PCT        50     // ... plus this share of its on-time
+#define CIRC_MIX_MIN_MS        15000UL
+#define CIRC_MIX_MAX_MS        120000UL
+#ifndef CIRC_IDLE_PERIOD_MS
+  #define CIRC_IDLE_PERIOD_MS  300000UL   // heater enabled but idle: one pulse per period
+#endif
+#define CIRC_PULSE_TURNOVERS   2
+#define CIRC_PULSE_MIN_MS      5000UL
+// Agitation level (% of full speed) vs heater error (setpoint - bath, °C):
+// piecewise linear between the points, flat beyond the ends. Hard during
+// warm-up, when moving heat off the element limits the ramp; quiet at hold.
+#ifndef CIRC_CURVE_ERR_C
+  #define CIRC_CURVE_ERR_C     { 0.0f, 1.0f, 3.0f, 6.0f }
+#endif
+#ifndef CIRC_CURVE_PCT
+  #define CIRC_CURVE_PCT       { 35, 45, 75, 100 }
+#endif
+#define CIRC_HEATING_MIN_PCT   60     // relay on: at least this, whatever the error
+#define CIRC_LEVEL_STEP_PCT    5      // level changes in these steps (no chasing probe noise)
+
+/* ----------------- Tanks ----------------- */
+// Tank 0 (etch) uses TS_PIN / PIN_HEATER_RELAY / PIN_PUMP above. A second
+// bath (e.g. tin plating) gets its own probe, relay and pump:
+#ifndef TANK_COUNT
+  #define TANK_COUNT 1          // 1..2
+#endif
+#ifndef TANK1_TS_PIN
+  #define TANK1_TS_PIN        4
+#endif
+#ifndef TANK1_RELAY_PIN
+  #define TANK1_RELAY_PIN     13
+#endif
+#ifndef TANK1_PUMP_PIN
+  #define TANK1_PUMP_PIN      2   // strapping pin: gate pull-down keeps it low at boot
+#endif
+#define TANK1_PUMP_LEDC_CH    1   // timer 0 with the tank 0 pump (same 20 kHz)
+#ifndef TANK1_PUMP_TACH_PIN
+  #define TANK1_PUMP_TACH_PIN -1  // e.g. 35
+#endif
+#define TANK1_PUMP_PCNT_UNIT  2
+#ifndef TANK1_VOLUME_L
+  #define TANK1_VOLUME_L      1.0f
+#endif
+#ifndef TANK1_TS_CHECK_PIN
+  #define TANK1_TS_CHECK_PIN  -1
+#endif
+#ifndef TANK1_TS_SHEATH_PIN
+  #define TANK1_TS_SHEATH_PIN -1
+#endif
+
+/* ----------------- Mains power budget ----------------- */
+// Ratings of the loads on the shared supply (W) and the cap they must stay
+// under together. Pumps always run; heaters are granted on-periods.
+#ifndef HEATER_W
+  #define HEATER_W             500
+#endif
+#ifndef PUMP_W
+  #define PUMP_W               30
+#endif
+#ifndef TANK1_HEATER_W
+  #define TANK1_HEATER_W       500
+#endif
+#ifndef TANK1_PUMP_W
+  #define TANK1_PUMP_W         30
+#endif
+#ifndef POWER_BUDGET_W
+  #define POWER_BUDGET_W       3000   // 16 A / 230 V circuit minus margin for other loads
+#endif
+#define POWER_SLICE_MS         60000  // heater run before it yields to a bath further behind
+#define POWER_YIELD_MARGIN_C   0.5f
+
+/* ----------------- Fleet load coordination (MQTT) ----------------- */
+// Stations on one circuit share FLEET_BREAKER_W through retained claims on
+// a local broker (fleet.h). Off by default: no WiFi stack is started.
+// Strings as build flags, e.g. -D FLEET_WIFI_SSID=\"werkplaats\"
+#ifndef FLEET_ENABLE
+  #define FLEET_ENABLE         0
+#endif
+#ifndef FLEET_WIFI_SSID
+  #define FLEET_WIFI_SSID      ""
 #endif
-#define HEATER_RELAY_ON   (HEATER_ACTIVE_HIGH ? HIGH : LOW)
-#define HEATER_RELAY_OFF  (HEATER_ACTIVE_HIGH ? LOW  : HIGH)
+#ifndef FLEET_WIFI_PASS
+  #define FLEET_WIFI_PASS      ""
+#endif
+#ifndef FLEET_MQTT_HOST
+  #define FLEET_MQTT_HOST      ""     // broker IP or DNS name (no mDNS)
+#endif
+#ifndef FLEET_MQTT_PORT
+  #define FLEET_MQTT_PORT      1883
+#endif
+#ifndef FLEET_MQTT_USER
+  #define FLEET_MQTT_USER      ""
+#endif
+#ifndef FLEET_MQTT_PASS
+  #define FLEET_MQTT_PASS      ""
+#endif
+#ifndef FLEET_TOPIC
+  #define FLEET_TOPIC          "protoetch/fleet"
+#endif
+#ifndef FLEET_ID
+  #define FLEET_ID             ""     // empty: "pe-" + last MAC bytes
+#endif
+#ifndef FLEET_BREAKER_W
+  #define FLEET_BREAKER_W      3600   // all stations together: 16 A x 230 V minus margin
+#endif
+#ifndef FLEET_OFFLINE_W
+  #define FLEET_OFFLINE_W      0      // heater watts allowed without the broker (also reserved by the will)
+#endif
+#define FLEET_SETTLE_MS        3000   // request published this long before acting on it
+#define FLEET_REFRESH_MS       5000   // claim re-published at least this often
+#define FLEET_TTL_MS           15000  // peer claim dropped without a refresh
+#define FLEET_POLL_MS          100    // MQTT upkeep + arbiter walk
+#define FLEET_RETRY_MIN_MS     1000   // broker reconnect backoff
+#define FLEET_RETRY_MAX_MS     30000
+#define FLEET_TASK_PRIO        1      // lowest app priority; a blocking connect only delays the walk
+#define FLEET_TASK_STACK       4096
+#define FLEET_TASK_CORE        0      // with the WiFi stack
 
 /* ----------------- Heater control defaults ----------------- */
 #ifndef HEATER_SETPOINT_C
@@ -53,6 +263,138 @@
 #ifndef HEATER_MIN_OFF_MS
   #define HEATER_MIN_OFF_MS    15000UL
 #endif
+// Cascade on a sheath probe: the bath error sets a sheath target
+// (setpoint + KP x error + I), the relay cycles around that target.
+// Tuned on 500 W in 2 L: same warm-up time as bath-only control, ~0.1 °C
+// overshoot instead of ~2 °C. The shorter holds suit an SSR; raise them
+// for a mechanical relay.
+#ifndef SHEATH_MAX_C
+  #define SHEATH_MAX_C         65.0f  // cap: hotter element surfaces decompose persulfate
+#endif
+#define CASCADE_KP             8.0f   // °C of sheath target per °C of bath error
+#define CASCADE_KI             0.005f // per °C of bath error per second
+#define CASCADE_HYST_C         2.0f   // relay band around the sheath target
+#define CASCADE_MIN_ON_MS      5000UL
+#define CASCADE_MIN_OFF_MS     5000UL
+
+/* ----------------- Heater fault detection ----------------- */
+// ThermalGuard trips, per tank, long before a dislodged probe would let the
+// bath reach HEATER_MAX_TEMP_C (thermal_guard.h). A trip drops the relay at
+// once and latches until the operator clears it (Button1 held).
+#define GUARD_RISE_MIN_C       1.0f   // heater on: at least this much rise ...
+#define GUARD_RISE_EFF_PCT     30     // ... in the time it takes at this share of the heater power
+#define GUARD_PROBE_LAG_MS     30000  //     plus the probe lag (500 W, 2 L: ~86 s)
+#define GUARD_STUCK_ON_MS      45000  // heater on-time without one LSB of change
+#define GUARD_RATE_MAX_C_PER_S 2.0f   // faster between two readings = not the bath
+#define GUARD_DISAGREE_C       2.0f   // bath vs check probe ...
+#define GUARD_DISAGREE_MS      10000  // ... for this long
+
+/* ----------------- Setpoint profiles ----------------- */
+// Ramp/soak recipes run by the control task (profile.h). The ramp holds
+// while the bath lags the ramped setpoint by more than the guarantee band,
+// and soak time only counts while the bath is within it of the target.
+#define PROFILE_MAX_SEGMENTS   6
+#define PROFILE_GUARANTEE_C    1.0f
+#ifndef PROFILE_DEFAULT
+  #define PROFILE_DEFAULT      0      // built-in recipe on a Button2 long press
+#endif
+
+/* ----------------- Standby and scheduled preheat ----------------- */
+// Idle baths drop to STANDBY_C and are preheated in time for the next
+// shift (standby.h). The calendar uses SNTP time over the fleet WiFi.
+#ifndef STANDBY_IDLE_MS
+  #define STANDBY_IDLE_MS      0      // idle -> standby, 0 = off (e.g. 1800000 = 30 min)
+#endif
+#ifndef STANDBY_C
+  #define STANDBY_C            30.0f
+#endif
+#define STANDBY_MARGIN_MS      600000 // preheat starts this much earlier than estimated
+#define STANDBY_RATE_INIT_C_PER_MIN 0.5f  // warm-up rate until one was learned (conservative)
+#define STANDBY_LEARN_ALPHA    0.3f
+#define STANDBY_LEARN_MIN_C    3.0f   // shorter warm-ups don't update the rate
+#ifndef STANDBY_SHIFT_DAYS
+  #define STANDBY_SHIFT_DAYS   0      // bit 0 = Sunday .. bit 6 = Saturday, e.g. 0x3E = Mon..Fri
+#endif
+#ifndef STANDBY_SHIFT_START_MIN
+  #define STANDBY_SHIFT_START_MIN 450 // minutes after midnight (07:30)
+#endif
+#ifndef STANDBY_TZ
+  #define STANDBY_TZ           "CET-1CEST,M3.5.0,M10.5.0/3"
+#endif
+#ifndef STANDBY_NTP
+  #define STANDBY_NTP          "pool.ntp.org"
+#endif
+#define STANDBY_POLL_MS        10000
+
+/* ----------------- Operator inputs ----------------- */
+// Rotary encoder (quadrature on PCNT) + push switch, two momentary buttons.
+// All switches are active-LOW with internal pull-ups.
+#ifndef PIN_ENC_A
+  #define PIN_ENC_A   32
+#endif
+#ifndef PIN_ENC_B
+  #define PIN_ENC_B   33
+#endif
+#ifndef PIN_ENC_SW
+  #define PIN_ENC_SW  22
+#endif
+#ifndef PIN_BTN1
+  #define PIN_BTN1    14
+#endif
+#ifndef PIN_BTN2
+  #define PIN_BTN2    27
+#endif
+#define ENC_COUNTS_PER_DETENT  4      // quadrature edges per mechanical click
+#define ENC_FILTER_CYCLES      1000   // PCNT glitch filter, APB cycles (12.5 us @ 80 MHz, max 1023)
+#define ENC_ACCEL_MAX          10     // step multiplier at full spin speed
+#define ENC_ACCEL_MIN_DPS      5      // detents/s below which steps are 1:1
+#define ENC_ACCEL_MAX_DPS      40     // detents/s at which ENC_ACCEL_MAX is reached
+#define BTN_DEBOUNCE_MS        20
+#define INPUT_SETPOINT_STEP_C  1.0f   // setpoint change per (accelerated) encoder step
+#define INPUT_LONG_PRESS_MS    800    // held this long: Button1 heater / fault reset, Button2 profile
+
+/* ----------------- UI ----------------- */
+// Panel rotation: 1/3 = 320x240 landscape, 0/2 = 240x320 portrait.
+// Selects the compile-time layout table in ui/layout.h.
+#ifndef UI_ROTATION
+  #define UI_ROTATION 1
+#endif
+// Backlight on LEDC channel 2 (timer 1): channels 0/1 share timer 0 with the pump
+#define UI_BL_LEDC_CH          2
+#define UI_BL_LEDC_HZ          5000
+#define UI_BL_FULL             255    // duty 0..255
+#define UI_BL_DIM              40
+#define UI_DIM_AFTER_MS        60000UL   // idle (no job, no input) -> dim
+#define UI_SLEEP_AFTER_MS      300000UL  // idle -> panel SLPIN, backlight off, no SPI
+#define TREND_SAMPLE_MS        5000   // one chart column per sample (~24 min on 320 px)
+#define TREND_SPAN_C           12.0f  // chart shows setpoint ± span
+
+/* ----------------- Control task ----------------- */
+#ifndef CTRL_PERIOD_MS
+  #define CTRL_PERIOD_MS       100    // fixed controller sample period
+#endif
+#define CTRL_TASK_PRIO         5      // above loop() (1), below esp_timer (22)
+#define CTRL_TASK_STACK        4096
+#define CTRL_TASK_CORE         1      // same core as loop(); WiFi stays on core 0
+
+/* ----------------- Timers ----------------- */
+#ifndef TIMERS_MAX
+  #define TIMERS_MAX           16     // timer wheel pool (see Timers::stats().peak)
+#endif
+
+/* ----------------- Power management ----------------- */
+// Dynamic frequency scaling (needs CONFIG_PM_ENABLE in the SDK config;
+// light sleep additionally needs CONFIG_FREERTOS_USE_TICKLESS_IDLE)
+#ifndef PM_MAX_MHZ
+  #define PM_MAX_MHZ           240
+#endif
+#ifndef PM_MIN_MHZ
+  #define PM_MIN_MHZ           80     // APB stays at 80 MHz at and above this
+#endif
+#ifndef PM_LIGHT_SLEEP
+  #define PM_LIGHT_SLEEP       1
+#endif
+#define PM_REPORT_MS           600000UL  // diagnostics log interval (PM residency, control timing)
 
 /* ----------------- Theme (GT40-ish) ----------------- */
 static inline uint16_t rgb565(uint32_t hex) {
@@ -63,4 +405,5 @@ static inline uint16_t rgb565(uint32_t hex) {
 #define COL_CARD    rgb565(0x0D2744)
 #define COL_SILVER  rgb565(0xA5A5A5) // RAL 9006-ish
 #define COL_ORANGE  rgb565(0xFF7F00)
-#define COL_WHITE   rgb565(0xFFFFFF)
\ No newline at end of file
+#define COL_WHITE   rgb565(0xFFFFFF)
+#define COL_GRID    rgb565(0x2E5077) // trend chart grid lines
\ No newline at end of file
@@ -0,0 +1,182 @@
+// Fixed-period control task (esp_timer -> task notification)
+#include "control_task.h"
+#include "config.h"
+#include "tanks.h"
+#include "power_budget.h"
+#include "fleet.h"
+#include "standby.h"
+#include "system_state.h"
+#include "timers.h"
+#include "scheduler.h"
+
+#include <esp_timer.h>
+
+namespace {
+  constexpr int64_t PERIOD_US = (int64_t)CTRL_PERIOD_MS * 1000;
+
+  TaskHandle_t       task  = nullptr;
+  esp_timer_handle_t timer = nullptr;
+  volatile int64_t   firedUs = 0;   // last timer expiry (esp_timer task)
+  int64_t            startUs = 0;   // phase reference for the ideal schedule
+  uint32_t           ticks   = 0;   // ideal tick index since startUs
+  ControlTask::Stats st{};
+  portMUX_TYPE       mux = portMUX_INITIALIZER_UNLOCKED;
+
+  // esp_timer task context: keep it to a timestamp and a notification
+  void onTimer(void*) {
+    firedUs = esp_timer_get_time();
+    xTaskNotifyGive(task);
+  }
+
+  // Snapshot for UI / telemetry; true when the tank's view changed
+  bool publish(uint8_t i, Temp::Raw temp) {
+    const Tank& t = Tanks::at(i);
+    SystemState s{};
+    s.atMs            = Timers::nowMs();
+    s.tempRaw         = temp;
+    s.setpointRaw     = t.heater.effectiveSetpointRaw();
+    s.hysteresisRaw   = t.heater.getHysteresisRaw();
+    s.sheathRaw       = t.heater.sheathRaw();
+    s.sheathTargetRaw = t.heater.sheathTargetRaw();
+    s.heaterEnabled   = t.heater.enabled();
+    s.relayOn         = t.heater.relayState();
+    s.pumpOn          = t.pump.isOn();
+    s.pumpFlow        = (uint8_t)t.pump.flow().state;
+    s.pumpTrip        = (uint8_t)t.pump.tripped();
+    s.profileState    = (uint8_t)t.profile.state();
+    s.profileSeg      = t.profile.segment();
+    s.standby         = (uint8_t)Standby::mode(i);
+    s.fault           = (uint8_t)t.guard.fault();
+    s.sensorPresent   = t.probe.present();
+    return SharedState::publish(i, s);
+  }
+
+  constexpr PowerBudget::Policy BUDGET = { POWER_BUDGET_W, POWER_SLICE_MS, POWER_YIELD_MARGIN_C };
+
+  // One control period, every tank: sample -> fault detectors -> advance the
+  // setpoint profile (else the standby override) -> sheath target (cascade) ->
+  // arbitrate the mains budget -> actuate -> publish. The loop is woken once if any tank's view changed.
+  // With fleet coordination the budget is further capped by the heater
+  // watts the other stations on the circuit leave us.
+  void step() {
+    const uint64_t       now = Timers::nowMs();
+    Temp::Raw            raw[Tanks::COUNT];   // 1/16 °C, probe to relay
+    float                tC[Tanks::COUNT];    // the same in °C for profile, standby and budget
+    PowerBudget::Request req[Tanks::COUNT];
+    bool                 grant[Tanks::COUNT];
+    uint16_t             fixedW = 0;
+    FleetArbiter::Demand fleet{};
+    for (uint8_t i = 0; i < Tanks::COUNT; ++i) {
+      Tank& t = Tanks::at(i);
+      raw[i] = t.probe.latestRaw();
+      tC[i]  = Temp::toC(raw[i]);
+      const ThermalGuard::Fault was = t.guard.fault();
+      const ThermalGuard::Fault f   = t.guard.check(now, raw[i], t.check ? t.check->latestRaw() : Temp::NONE,
+                                                    t.heater.heating(now));
+      if (f != was && f != ThermalGuard::Fault::None) {
+        LOGE("[Guard] %s: %s (%.2f), heater off until reset\n", t.name, ThermalGuard::name(f), t.guard.detail());
+      }
+      t.heater.setTripped(f != ThermalGuard::Fault::None);
+      float effC = t.profile.tick(tC[i], t.heater.getSetpointC(), now);
+      if (isnan(effC)) effC = Standby::setpointC(i);
+      t.heater.setEffective(effC);
+      t.heater.cascade(raw[i], t.sheath ? t.sheath->latestRaw() : Temp::NONE, now);
+      req[i].want       = t.heater.wantsHeat(raw[i]);
+      req[i].on         = t.heater.relayState();
+      req[i].switchable = t.heater.switchable(now);
+      req[i].deficitC   = raw[i] == Temp::NONE ? 0.0f : Temp::toC(t.heater.effectiveSetpointRaw() - raw[i]);
+      req[i].inStateMs  = t.heater.msInState(now);
+      req[i].watts      = t.heaterW;
+      if (t.pump.isOn()) fixedW += t.pumpW;
+      if (req[i].on) fleet.onW += t.heaterW;
+      if (req[i].want) {
+        fleet.prio  = fleet.wantW ? max(fleet.prio, req[i].deficitC) : req[i].deficitC;
+        fleet.minW  = fleet.wantW ? min(fleet.minW, t.heaterW) : t.heaterW;
+        fleet.wantW += t.heaterW;
+      }
+    }
+    fleet.baseW = fixedW;
+    Fleet::demand(fleet);
+
+    PowerBudget::Policy budget = BUDGET;
+    const uint32_t fleetCapW = (uint32_t)fixedW + Fleet::heatW();
+    if (fleetCapW < budget.capW) budget.capW = (uint16_t)fleetCapW;
+    PowerBudget::arbitrate(req, Tanks::COUNT, fixedW, budget, grant);
+
+    // Releases before grants, so a handed-over slot never overlaps
+    for (uint8_t pass = 0; pass < 2; ++pass) {
+      for (uint8_t i = 0; i < Tanks::COUNT; ++i) {
+        if (grant[i] == (pass == 1)) Tanks::at(i).heater.tick(raw[i], grant[i]);
+      }
+    }
+
+    bool changed = false;
+    for (uint8_t i = 0; i < Tanks::COUNT; ++i) changed |= publish(i, raw[i]);
+    if (changed) Sched::wake();
+  }
+
+  void run(void*) {
+    for (;;) {
+      // More than one pending notification = periods lost while we ran late
+      const uint32_t pending = ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+      const int64_t  t0      = esp_timer_get_time();
+      ticks += pending;
+      const int64_t  ideal   = startUs + (int64_t)ticks * PERIOD_US;
+      const int64_t  jitter  = t0 - ideal;
+      const uint32_t absJ    = (uint32_t)(jitter < 0 ? -jitter : jitter);
+      const uint32_t latency = (uint32_t)(t0 - firedUs);
+
+      step();
+
+      const uint32_t exec = (uint32_t)(esp_timer_get_time() - t0);
+      portENTER_CRITICAL(&mux);
+      st.ticks++;
+      if (pending > 1) st.overruns += pending - 1;
+      st.sumJitterUs += absJ;
+      if (absJ    > st.maxJitterUs)  st.maxJitterUs  = absJ;
+      if (latency > st.maxLatencyUs) st.maxLatencyUs = latency;
+      if (exec    > st.maxExecUs)    st.maxExecUs    = exec;
+      portEXIT_CRITICAL(&mux);
+    }
+  }
+}
+
+namespace ControlTask {
+
+void begin() {
+  // Readers never see an empty snapshot
+  for (uint8_t i = 0; i < Tanks::COUNT; ++i) publish(i, Tanks::at(i).probe.latestRaw());
+  xTaskCreatePinnedToCore(run, "control", CTRL_TASK_STACK, nullptr,
+                          CTRL_TASK_PRIO, &task, CTRL_TASK_CORE);
+  esp_timer_create_args_t args = {};
+  args.callback        = onTimer;
+  args.dispatch_method = ESP_TIMER_TASK;
+  args.name            = "control";
+  esp_timer_create(&args, &timer);
+  startUs = esp_timer_get_time();
+  esp_timer_start_periodic(timer, PERIOD_US);
+  LOGI("[Control] %d ms tick, task prio %d on core %d\n", CTRL_PERIOD_MS, CTRL_TASK_PRIO, CTRL_TASK_CORE);
+}
+
+Stats stats() {
+  portENTER_CRITICAL(&mux);
+  const Stats s = st;
+  portEXIT_CRITICAL(&mux);
+  return s;
+}
+
+void resetStats() {
+  portENTER_CRITICAL(&mux);
+  st = {};
+  portEXIT_CRITICAL(&mux);
+}
+
+void report() {
+  const Stats s = stats();
+  LOGI("[Control] ticks=%lu overruns=%lu jitter avg=%luus max=%luus latency max=%luus exec max=%luus\n",
+       (unsigned long)s.ticks, (unsigned long)s.overruns,
+       (unsigned long)(s.ticks ? s.sumJitterUs / s.ticks : 0), (unsigned long)s.maxJitterUs,
+       (unsigned long)s.maxLatencyUs, (unsigned long)s.maxExecUs);
+}
+
+} // namespace ControlTask
@@ -0,0 +1,35 @@
+#pragma once
+#include <Arduino.h>
+
+/*
+  Fixed-period control tick
+  - A periodic esp_timer fires every CTRL_PERIOD_MS and notifies a
+    dedicated high-priority task
+  - Each tick runs every tank (Tanks): sample the latest probe reading,
+    run its controller and drive its relay, independent of display /
+    1-Wire load on the loop task
+  - Each tick publishes one SystemState snapshot per tank (SharedState);
+    the loop task is woken when any snapshot changed (UI, pump trigger)
+*/
+namespace ControlTask {
+
+/** Timing statistics since boot (or the last resetStats()). */
+struct Stats {
+  uint32_t ticks;         // control ticks executed
+  uint32_t overruns;      // ticks where the previous one was still running (periods lost)
+  uint32_t maxLatencyUs;  // timer expiry -> task running
+  uint32_t maxJitterUs;   // |tick start - ideal start|
+  uint64_t sumJitterUs;   // for the mean: sumJitterUs / ticks
+  uint32_t maxExecUs;     // longest tick body
+};
+
+/** Start the periodic timer and the control task (after Tanks::begin()). */
+void begin();
+
+Stats stats();
+void  resetStats();
+
+/** Log jitter / overrun figures. */
+void report();
+
+} // namespace ControlTask
@@ -0,0 +1,164 @@
+// Fleet load coordination transport: WiFi + MQTT (see fleet.h)
+#include "fleet.h"
+#include "config.h"
+#include "seqlock.h"
+#include "tanks.h"
+#include "timers.h"
+
+#include <atomic>
+#if FLEET_ENABLE
+  #include <WiFi.h>
+  #include <PubSubClient.h>
+  #include <freertos/FreeRTOS.h>
+  #include <freertos/task.h>
+#endif
+
+namespace {
+  SeqLock<FleetArbiter::Demand> demandLock;                         // control task -> loop
+  std::atomic<uint16_t>         granted{FLEET_ENABLE ? 0 : UINT16_MAX};
+  std::atomic<bool>             up{false};
+
+#if FLEET_ENABLE
+  constexpr FleetArbiter::Policy POLICY = {
+    FLEET_BREAKER_W, FLEET_SETTLE_MS, POWER_SLICE_MS, FLEET_TTL_MS, POWER_YIELD_MARGIN_C, FLEET_OFFLINE_W
+  };
+
+  FleetArbiter* arb = nullptr;            // fleet task only
+  SeqLock<FleetArbiter::Stats> statsLock;  // fleet task -> report()
+  WiFiClient    net;
+  PubSubClient  mqtt(net);
+  char          selfId[FleetArbiter::ID_LEN];
+  char          selfTopic[96];
+  char          allTopic[96];
+  char          will[96];
+  uint64_t      lastPubMs  = 0;
+  uint64_t      retryAtMs  = 0;
+  uint32_t      backoffMs  = FLEET_RETRY_MIN_MS;
+  std::atomic<uint32_t> connects{0};
+
+  // Runs inside mqtt.loop(), i.e. on the fleet task like the rest of the walk
+  void onMessage(char* topic, uint8_t* payload, unsigned int len) {
+    char text[128];
+    if (len >= sizeof(text)) {
+      LOGW("[Fleet] Claim on %s too long (%u bytes)\n", topic, len);
+      return;
+    }
+    memcpy(text, payload, len);
+    text[len] = '\0';
+    const char* id = strrchr(topic, '/');
+    if (!id || !arb->onPeer(id + 1, text, Timers::nowMs())) {
+      LOGW("[Fleet] Ignored claim on %s: '%s'\n", topic, text);
+    }
+  }
+
+  // Blocks for DNS, the TCP connect (about 3 s to an unreachable broker)
+  // and CONNACK; that is why all of MQTT lives on its own task and never
+  // stalls input, UI or circulation on the loop task
+  bool connect(uint64_t now) {
+    if (now < retryAtMs) return false;
+    const char* user = FLEET_MQTT_USER[0] ? FLEET_MQTT_USER : nullptr;
+    const char* pass = FLEET_MQTT_PASS[0] ? FLEET_MQTT_PASS : nullptr;
+    if (mqtt.connect(selfId, user, pass, selfTopic, 0, true, will) && mqtt.subscribe(allTopic)) {
+      LOGI("[Fleet] %s connected to %s:%d\n", selfId, FLEET_MQTT_HOST, FLEET_MQTT_PORT);
+      backoffMs = FLEET_RETRY_MIN_MS;
+      connects.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+    LOGW("[Fleet] MQTT connect failed (state %d), retry in %lu ms\n", mqtt.state(), (unsigned long)backoffMs);
+    mqtt.disconnect();
+    retryAtMs = now + backoffMs;
+    backoffMs = min<uint32_t>(backoffMs * 2, FLEET_RETRY_MAX_MS);
+    return false;
+  }
+
+  // Connection upkeep -> peer claims in -> walk -> own claim out
+  void poll() {
+    const uint64_t now  = Timers::nowMs();
+    const bool     link = WiFi.status() == WL_CONNECTED && (mqtt.connected() || connect(now));
+    if (link != up.load()) {
+      arb->setOnline(link, now);
+      up.store(link);
+      if (!link) LOGW("[Fleet] Offline, heaters limited to %d W\n", FLEET_OFFLINE_W);
+    }
+    if (link) mqtt.loop();
+
+    granted.store(arb->update(demandLock.read(), now));
+
+    if (link && (arb->dirty() || now - lastPubMs >= FLEET_REFRESH_MS)) {
+      char payload[96];
+      const size_t n = arb->claim(payload, sizeof(payload), now);
+      if (mqtt.publish(selfTopic, (const uint8_t*)payload, n, true)) lastPubMs = now;
+    }
+    statsLock.write(arb->stats());
+  }
+
+  void run(void*) {
+    TickType_t wakeAt = xTaskGetTickCount();
+    for (;;) {
+      poll();
+      vTaskDelayUntil(&wakeAt, pdMS_TO_TICKS(FLEET_POLL_MS));
+    }
+  }
+#endif
+}
+
+namespace Fleet {
+
+void begin() {
+#if FLEET_ENABLE
+  if (!FLEET_WIFI_SSID[0] || !FLEET_MQTT_HOST[0]) {
+    LOGE("[Fleet] FLEET_WIFI_SSID / FLEET_MQTT_HOST not set, heaters limited to %d W\n", FLEET_OFFLINE_W);
+    granted.store(FLEET_OFFLINE_W);
+    return;
+  }
+  if (FLEET_ID[0]) {
+    snprintf(selfId, sizeof(selfId), "%s", FLEET_ID);
+  } else {
+    snprintf(selfId, sizeof(selfId), "pe-%06lx", (unsigned long)((ESP.getEfuseMac() >> 24) & 0xFFFFFF));
+  }
+  snprintf(selfTopic, sizeof(selfTopic), "%s/load/%s", FLEET_TOPIC, selfId);
+  snprintf(allTopic,  sizeof(allTopic),  "%s/load/+",  FLEET_TOPIC);
+
+  // Last will: a station that drops off keeps its offline allowance and
+  // pumps reserved until it reconnects
+  uint16_t pumpsW = 0;
+  for (uint8_t i = 0; i < Tanks::COUNT; ++i) pumpsW += Tanks::at(i).pumpW;
+  FleetArbiter::format({ FLEET_OFFLINE_W, FLEET_OFFLINE_W, FLEET_OFFLINE_W, pumpsW, 0.0f, 0, 0 },
+                       will, sizeof(will));
+
+  static FleetArbiter a(selfId, POLICY);
+  arb = &a;
+
+  WiFi.mode(WIFI_STA);
+  WiFi.setAutoReconnect(true);
+  WiFi.begin(FLEET_WIFI_SSID, FLEET_WIFI_PASS);
+  mqtt.setServer(FLEET_MQTT_HOST, FLEET_MQTT_PORT);
+  mqtt.setCallback(onMessage);
+  mqtt.setSocketTimeout(2);
+  statsLock.write(arb->stats());
+  xTaskCreatePinnedToCore(run, "fleet", FLEET_TASK_STACK, nullptr, FLEET_TASK_PRIO, nullptr, FLEET_TASK_CORE);
+  LOGI("[Fleet] %s: breaker %d W shared via %s\n", selfId, FLEET_BREAKER_W, allTopic);
+#else
+  LOGI("[Fleet] Disabled (FLEET_ENABLE=0)\n");
+#endif
+}
+
+void demand(const FleetArbiter::Demand& d) { demandLock.write(d); }
+
+uint16_t heatW() { return granted.load(); }
+
+bool online() { return up.load(); }
+
+void report() {
+#if FLEET_ENABLE
+  if (!arb) return;
+  const FleetArbiter::Stats s = statsLock.read();
+  LOGI("[Fleet] %s, %u peers, granted %u W, fleet peak %u W, grants %lu, yields %lu, sheds %lu, "
+       "expired %lu, rejected %lu, connects %lu\n",
+       up.load() ? "online" : "offline", (unsigned)s.peers, (unsigned)granted.load(), (unsigned)s.peakW,
+       (unsigned long)s.grants, (unsigned long)s.yields, (unsigned long)s.sheds,
+       (unsigned long)s.expired, (unsigned long)s.rejected, (unsigned long)connects.load());
+#endif
+}
+
+} // namespace Fleet
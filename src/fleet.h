@@ -0,0 +1,37 @@
+#pragma once
+#include <Arduino.h>
+#include "fleet_arbiter.h"
+
+/*
+  Fleet load coordination over MQTT (FLEET_ENABLE).
+  Stations on one mains circuit publish their heater claim, retained, to
+  FLEET_TOPIC/load/<id> on a local broker and read everyone else's; the
+  FleetArbiter walk decides how many heater watts this station may draw so
+  the stations together stay under FLEET_BREAKER_W.
+  - The control task hands over its demand every tick (demand()) and caps
+    its mains power budget with heatW()
+  - WiFi, MQTT and the walk run on their own low-priority task (core 0,
+    every FLEET_POLL_MS): a broker connect blocks for seconds and must not
+    stall the loop task
+  - While disconnected the heaters are limited to FLEET_OFFLINE_W; the last
+    will keeps that much reserved for a station that drops off the broker
+  Disabled builds start no WiFi and heatW() does not limit anything.
+*/
+namespace Fleet {
+
+/** Start WiFi + MQTT and the fleet task (after Timers::begin() and Tanks::begin()). */
+void begin();
+
+/** This station's heater demand; called by the control task every tick. */
+void demand(const FleetArbiter::Demand& d);
+
+/** Heater watts the fleet grants this station (UINT16_MAX when disabled). */
+uint16_t heatW();
+
+/** True while connected to the broker. */
+bool online();
+
+/** Log connection state and arbiter counters. */
+void report();
+
+} // namespace Fleet
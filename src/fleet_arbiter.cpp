@@ -0,0 +1,256 @@
+// Fleet load coordination walk (see fleet_arbiter.h)
+#include "fleet_arbiter.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace {
+  constexpr uint8_t MAX_ENTRIES = FleetArbiter::MAX_PEERS + 1;
+
+  struct Entry {
+    const char*         id;
+    FleetArbiter::Claim c;
+    bool                self;
+  };
+
+  // The same total order on every station: priority, then id
+  bool ahead(const Entry& a, const Entry& b) {
+    if (a.c.prio != b.c.prio) return a.c.prio > b.c.prio;
+    return strcmp(a.id, b.id) < 0;
+  }
+
+  // Priority exactly as peers parse it back from format()
+  float quantize(float c) { return roundf(c * 100.0f) / 100.0f; }
+
+  uint16_t clamp16(unsigned long v) { return v > UINT16_MAX ? UINT16_MAX : (uint16_t)v; }
+}
+
+FleetArbiter::FleetArbiter(const char* selfId, const Policy& p) : p_(p) {
+  strncpy(id_, selfId, ID_LEN - 1);
+  id_[ID_LEN - 1] = '\0';
+}
+
+FleetArbiter::Peer* FleetArbiter::find(const char* id) {
+  for (uint8_t i = 0; i < nPeers_; ++i) {
+    if (!strcmp(peers_[i].id, id)) return &peers_[i];
+  }
+  return nullptr;
+}
+
+bool FleetArbiter::onPeer(const char* id, const char* payload, uint64_t nowMs) {
+  if (!strcmp(id, id_)) return true;               // our own retained claim
+  Peer* pr = find(id);
+  if (!*payload) {                                 // retained claim cleared
+    if (pr) *pr = peers_[--nPeers_];
+    return true;
+  }
+  Claim c;
+  if (strlen(id) >= ID_LEN || !parse(payload, c)) { st_.rejected++; return false; }
+  if (!pr) {
+    if (nPeers_ == MAX_PEERS) { st_.rejected++; return false; }
+    pr = &peers_[nPeers_++];
+    strcpy(pr->id, id);
+  }
+  pr->c      = c;
+  pr->seenMs = nowMs;
+  return true;
+}
+
+void FleetArbiter::expire(uint64_t nowMs) {
+  for (uint8_t i = 0; i < nPeers_;) {
+    const Peer& pr = peers_[i];
+    if (pr.c.ttlMs && nowMs - pr.seenMs > pr.c.ttlMs) {
+      peers_[i] = peers_[--nPeers_];
+      st_.expired++;
+    } else {
+      ++i;
+    }
+  }
+}
+
+void FleetArbiter::setOnline(bool online, uint64_t nowMs) {
+  if (online == online_) return;
+  online_ = online;
+  nPeers_ = 0;          // offline they go stale; online the retained claims arrive again
+  dirty_  = true;
+  // Collect the retained claims for a settle period before taking more
+  requestSince_ = (online && d_.wantW > held_) ? nowMs : NEVER;
+  resent_       = false;
+}
+
+void FleetArbiter::setHeld(uint16_t w, uint64_t nowMs) {
+  if (w && !held_) heldSince_ = nowMs;
+  held_ = w;
+}
+
+FleetArbiter::Claim FleetArbiter::self(uint64_t nowMs) const {
+  Claim c{};
+  c.heldW = held_ > d_.onW ? held_ : d_.onW;
+  c.wantW = d_.wantW > c.heldW ? d_.wantW : c.heldW;
+  c.minW  = d_.minW;
+  c.baseW = d_.baseW;
+  c.prio  = pubPrio_;
+  if (held_) {
+    const uint64_t ran = nowMs - heldSince_;
+    c.windowMs = ran >= p_.sliceMs ? 0 : (uint32_t)(p_.sliceMs - ran);
+  } else if (c.wantW > c.heldW) {
+    c.windowMs = p_.sliceMs;
+  }
+  c.ttlMs = p_.ttlMs;
+  return c;
+}
+
+uint16_t FleetArbiter::update(const Demand& d, uint64_t nowMs) {
+  d_ = d;
+  expire(nowMs);
+
+  if (!online_) {
+    setHeld(d.wantW < p_.offlineW ? d.wantW : p_.offlineW, nowMs);
+    return held_;
+  }
+
+  if (held_ > d.wantW) setHeld(d.wantW, nowMs);      // demand dropped: hand back the rest
+  if (d.wantW <= held_) {
+    requestSince_ = NEVER;
+  } else if (requestSince_ == NEVER) {
+    requestSince_ = nowMs;
+    resent_       = false;
+  }
+  // Send the request a second time halfway through the settle period, so one
+  // lost claim does not let two stations commit the same watts
+  if (requestSince_ != NEVER && !resent_ && nowMs - requestSince_ >= p_.settleMs / 2) {
+    resent_ = true;
+    dirty_  = true;
+  }
+
+  // Every station's claim (ours as peers see it), in rank order
+  Entry   e[MAX_ENTRIES];
+  uint8_t n = 0, me = 0;
+  for (uint8_t i = 0; i < nPeers_; ++i) e[n++] = { peers_[i].id, peers_[i].c, false };
+  e[n++] = { id_, self(nowMs), true };
+  for (uint8_t i = 1; i < n; ++i) {
+    const Entry x = e[i];
+    uint8_t k = i;
+    while (k && ahead(x, e[k - 1])) { e[k] = e[k - 1]; --k; }
+    e[k] = x;
+  }
+
+  int32_t base = 0, held = 0;
+  for (uint8_t k = 0; k < n; ++k) {
+    base += e[k].c.baseW;
+    held += e[k].c.heldW;
+    if (e[k].self) me = k;
+  }
+  if (base + held > st_.peakW) st_.peakW = clamp16(base + held);
+
+  // 1) Over-committed: holders keep their watts in rank order; cut ours if it no longer fits
+  if (base + held > p_.breakerW && held_) {
+    int32_t avail = (int32_t)p_.breakerW - base;
+    for (uint8_t k = 0; k < me; ++k) avail -= e[k].c.heldW;
+    if (held_ > avail) {
+      setHeld((d.minW && d.minW <= avail) ? d.minW : 0, nowMs);
+      st_.sheds++;
+      held -= e[me].c.heldW;
+      e[me].c = self(nowMs);
+      held += e[me].c.heldW;
+    }
+  }
+
+  // 2) Waiting stations in rank order while the breaker has room. Everyone
+  //    reserves the same slots, so a station only ever takes its own.
+  int32_t  avail   = (int32_t)p_.breakerW - base - held;
+  bool     blocked = false;    // first waiting peer that got nothing
+  float    bPrio   = 0.0f;
+  int32_t  bNeed   = 0;
+  for (uint8_t k = 0; k < n; ++k) {
+    const Claim& c = e[k].c;
+    if (c.wantW <= c.heldW) continue;
+    const int32_t need = c.wantW - c.heldW;
+    const int32_t g    = need <= avail ? need : (c.minW && c.minW <= avail ? c.minW : 0);
+    if (e[k].self) {
+      if (g > 0 && nowMs - requestSince_ >= p_.settleMs) {
+        setHeld(c.heldW + g, nowMs);
+        st_.grants++;
+        if (held_ >= d.wantW) requestSince_ = NEVER;
+      }
+    } else if (!g && !blocked) {
+      blocked = true;
+      bPrio   = c.prio;
+      bNeed   = (c.minW && c.minW < need ? c.minW : need) - avail;
+    }
+    avail -= g;
+  }
+
+  // 3) Time slice used up and a station further behind is waiting for
+  //    watts our hold would free: hand it over and queue again
+  if (held_ && blocked && nowMs - heldSince_ >= p_.sliceMs
+      && bPrio >= pubPrio_ + p_.yieldMarginC && bNeed <= held_) {
+    setHeld(0, nowMs);
+    st_.yields++;
+    if (d.wantW) { requestSince_ = nowMs; resent_ = false; }
+  }
+
+  const Claim s = self(nowMs);
+  dirty_ |= s.heldW != pub_.heldW || s.wantW != pub_.wantW
+         || s.minW != pub_.minW || s.baseW != pub_.baseW;
+  return held_;
+}
+
+size_t FleetArbiter::claim(char* buf, size_t len, uint64_t nowMs) {
+  Claim c = self(nowMs);
+  c.prio   = quantize(d_.prio);
+  pubPrio_ = c.prio;
+  pub_     = c;
+  dirty_   = false;
+  return format(c, buf, len);
+}
+
+size_t FleetArbiter::format(const Claim& c, char* buf, size_t len) {
+  const int r = snprintf(buf, len, "held=%u want=%u min=%u base=%u prio=%.2f window=%lu ttl=%lu",
+                         (unsigned)c.heldW, (unsigned)c.wantW, (unsigned)c.minW, (unsigned)c.baseW,
+                         (double)c.prio, (unsigned long)c.windowMs, (unsigned long)c.ttlMs);
+  if (r < 0 || !len) return 0;
+  return (size_t)r < len ? (size_t)r : len - 1;
+}
+
+bool FleetArbiter::parse(const char* s, Claim& out) {
+  Claim   c{};
+  uint8_t seen = 0;    // held, want, base are required; unknown keys are skipped
+  bool    hasMin = false;
+  while (*s) {
+    if (*s == ' ') { ++s; continue; }
+    const char* eq = strchr(s, '=');
+    if (!eq) return false;
+    const size_t klen = eq - s;
+    auto key = [&](const char* k) { return strlen(k) == klen && !strncmp(s, k, klen); };
+    const char* v = eq + 1;
+    char* end;
+    if (key("prio")) {
+      c.prio = strtof(v, &end);
+      if (!isfinite(c.prio)) return false;
+    } else {
+      if (*v == '-') return false;
+      const unsigned long x = strtoul(v, &end, 10);
+      if      (key("held"))   { c.heldW = clamp16(x); seen |= 1; }
+      else if (key("want"))   { c.wantW = clamp16(x); seen |= 2; }
+      else if (key("base"))   { c.baseW = clamp16(x); seen |= 4; }
+      else if (key("min"))    { c.minW  = clamp16(x); hasMin = true; }
+      else if (key("window")) { c.windowMs = (uint32_t)x; }
+      else if (key("ttl"))    { c.ttlMs    = (uint32_t)x; }
+    }
+    if (end == v || (*end && *end != ' ')) return false;
+    s = end;
+  }
+  if (seen != 7) return false;
+  if (c.wantW < c.heldW) c.wantW = c.heldW;
+  if (!hasMin) c.minW = c.wantW - c.heldW;
+  out = c;
+  return true;
+}
+
+FleetArbiter::Stats FleetArbiter::stats() const {
+  Stats s = st_;
+  s.peers = nPeers_;
+  return s;
+}
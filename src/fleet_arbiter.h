@@ -0,0 +1,121 @@
+#pragma once
+// Fleet-wide heater load coordination (transport-independent core)
+//
+// Several stations share one mains circuit. Each publishes a claim: the
+// heater watts it holds, the watts it wants, its pump load and a priority
+// (largest setpoint deficit). Every station runs the same deterministic walk
+// over the claims it has seen, so they agree on who may switch on next
+// without a central coordinator:
+//  - pump loads and held heater watts of all stations count first
+//  - waiting stations are served in priority order (ties by id) while the
+//    breaker rating has room; a station acts on its own request only after
+//    it has been published for settleMs, so peers reserve it first
+//  - a holder whose slice is used up yields to a waiting station further
+//    behind; if holders ever over-commit (lost or late claim), the
+//    lowest-ranked ones drop back
+// Pure logic (no Arduino dependency): tools/fleet_sim runs several stations
+// on a host, in-process or against a local MQTT broker.
+
+#include <stdint.h>
+#include <stddef.h>
+
+class FleetArbiter {
+public:
+  static constexpr uint8_t ID_LEN    = 24;  // station id incl. terminator
+  static constexpr uint8_t MAX_PEERS = 16;
+
+  /** One station's announcement (payload of its claim topic, see format()). */
+  struct Claim {
+    uint16_t heldW;     // heater watts it draws / may draw now
+    uint16_t wantW;     // heater watts it would draw if granted (>= heldW)
+    uint16_t minW;      // smallest useful step (one heater)
+    uint16_t baseW;     // load that is not arbitrated (running pumps)
+    float    prio;      // largest setpoint deficit in °C, higher goes first
+    uint32_t windowMs;  // planned on-window: rest of the slice, or the slice asked for
+    uint32_t ttlMs;     // lifetime without refresh; 0 = until replaced (last will)
+  };
+
+  /** This station's demand, from the control tick. */
+  struct Demand {
+    uint16_t wantW;  // heaters that want heat, including those on
+    uint16_t minW;   // smallest heater that wants heat
+    uint16_t onW;    // heaters actually on (a min-on hold draws without a grant)
+    uint16_t baseW;  // running pumps
+    float    prio;
+  };
+
+  struct Policy {
+    uint16_t breakerW;      // aggregate limit for all stations
+    uint32_t settleMs;      // own request visible this long before it is acted on
+    uint32_t sliceMs;       // hold before yielding to a station further behind
+    uint32_t ttlMs;         // claim lifetime without refresh
+    float    yieldMarginC;  // waiting station must be this much further behind
+    uint16_t offlineW;      // own heater draw allowed while disconnected
+  };
+
+  struct Stats {
+    uint32_t grants;    // holds taken or grown
+    uint32_t yields;    // holds handed to a station further behind
+    uint32_t sheds;     // holds cut because the fleet was over-committed
+    uint32_t expired;   // peer claims aged out
+    uint32_t rejected;  // malformed claims or full peer table
+    uint16_t peakW;     // highest aggregate draw seen (held + base, all stations)
+    uint8_t  peers;     // peers currently known
+  };
+
+  FleetArbiter(const char* selfId, const Policy& p);
+
+  /** A peer's claim arrived (`id` from its topic). An empty payload removes it. */
+  bool onPeer(const char* id, const char* payload, uint64_t nowMs);
+
+  /** Broker reachable or not. Offline, peers are forgotten and the grant is offlineW. */
+  void setOnline(bool online, uint64_t nowMs);
+
+  /** Run the walk with the latest local demand; returns the heater watts granted. */
+  uint16_t update(const Demand& d, uint64_t nowMs);
+
+  uint16_t grantW() const { return held_; }
+
+  /** True when held/want/min/base changed since the last claim() (publish now). */
+  bool dirty() const { return dirty_; }
+
+  /** Format the current claim for publishing and mark it published. */
+  size_t claim(char* buf, size_t len, uint64_t nowMs);
+
+  /** Text form: "held=500 want=500 min=500 base=30 prio=3.25 window=60000 ttl=15000". */
+  static size_t format(const Claim& c, char* buf, size_t len);
+  static bool   parse(const char* payload, Claim& out);
+
+  const char* id() const { return id_; }
+  Stats stats() const;
+
+private:
+  struct Peer {
+    char     id[ID_LEN];
+    Claim    c;
+    uint64_t seenMs;
+  };
+
+  Peer*   find(const char* id);
+  void    expire(uint64_t nowMs);
+  Claim   self(uint64_t nowMs) const;
+  void    setHeld(uint16_t w, uint64_t nowMs);
+
+  static constexpr uint64_t NEVER = UINT64_MAX;
+
+  char     id_[ID_LEN];
+  Policy   p_;
+  Peer     peers_[MAX_PEERS];
+  uint8_t  nPeers_      = 0;
+  bool     online_      = false;
+
+  Demand   d_{};
+  uint16_t held_        = 0;
+  uint64_t heldSince_   = 0;
+  uint64_t requestSince_ = NEVER;
+  bool     resent_      = false;
+  float    pubPrio_     = 0.0f;   // priority as peers last saw it
+  Claim    pub_{};                // last published held/want/min/base
+  bool     dirty_       = true;
+  Stats    st_{};
+};
@@ -0,0 +1,96 @@
+#pragma once
+// Compile-time GPIO output HAL
+//
+// OutPin<Pin, ActiveHigh> is a type, not an object: pin and polarity are
+// template parameters, so set() compiles to a single store into the GPIO
+// set/clear register (GPIO.out_w1ts / out_w1tc) with no pin lookup and no
+// polarity branch. An actuator declared once as a type (see actuators.h)
+// cannot be driven with the wrong polarity anywhere else.
+//
+// Without ARDUINO (host build) the registers are a plain fake, so code that
+// uses the HAL compiles and can be exercised on Linux.
+
+#include <stdint.h>
+
+#ifdef ARDUINO
+  #include <Arduino.h>
+  #include <soc/gpio_struct.h>
+#endif
+
+namespace Hal {
+
+#ifndef ARDUINO
+/** Host fake of the GPIO output registers (bit n = GPIOn). */
+struct FakeGpio {
+  uint64_t level  = 0;   // output latch
+  uint64_t output = 0;   // output enable
+  uint32_t writes = 0;   // set/clear register stores
+};
+inline FakeGpio fakeGpio;
+#endif
+
+namespace detail {
+
+#ifdef ARDUINO
+  // GPIO0..31 live in out/out_w1ts/out_w1tc, GPIO32/33 in the out1 bank
+  template <uint8_t Pin> inline void high() {
+    if (Pin < 32) GPIO.out_w1ts = 1UL << Pin;
+    else          GPIO.out1_w1ts.val = 1UL << (Pin - 32);
+  }
+  template <uint8_t Pin> inline void low() {
+    if (Pin < 32) GPIO.out_w1tc = 1UL << Pin;
+    else          GPIO.out1_w1tc.val = 1UL << (Pin - 32);
+  }
+  template <uint8_t Pin> inline bool latch() {
+    return Pin < 32 ? (GPIO.out >> Pin) & 1 : (GPIO.out1.val >> (Pin - 32)) & 1;
+  }
+  template <uint8_t Pin> inline void enableOutput() { pinMode(Pin, OUTPUT); }
+#else
+  template <uint8_t Pin> inline void high()         { fakeGpio.level |=  (1ULL << Pin); fakeGpio.writes++; }
+  template <uint8_t Pin> inline void low()          { fakeGpio.level &= ~(1ULL << Pin); fakeGpio.writes++; }
+  template <uint8_t Pin> inline bool latch()        { return (fakeGpio.level >> Pin) & 1; }
+  template <uint8_t Pin> inline void enableOutput() { fakeGpio.output |= 1ULL << Pin; }
+#endif
+
+} // namespace detail
+
+template <uint8_t Pin, bool ActiveHigh>
+struct OutPin {
+  static_assert(Pin < 34, "GPIO34..39 are input-only");
+  static_assert(Pin < 6 || Pin > 11, "GPIO6..11 are wired to the SPI flash");
+
+  static constexpr uint8_t pin        = Pin;
+  static constexpr bool    activeHigh = ActiveHigh;
+
+  /** Latch the inactive level first, then enable the driver: no glitch at boot. */
+  static void begin() {
+    set(false);
+    detail::enableOutput<Pin>();
+  }
+
+  /** Drive the actuator on (true) or off; polarity is resolved at compile time. */
+  static inline void set(bool on) {
+    if (on == ActiveHigh) detail::high<Pin>();
+    else                  detail::low<Pin>();
+  }
+
+  /** Actuator state as currently latched in the output register. */
+  static inline bool isOn() { return detail::latch<Pin>() == ActiveHigh; }
+};
+
+/**
+ * Runtime handle to an OutPin type, for classes wired per instance (one
+ * relay per tank). Pin and polarity stay compile-time inside set(); the
+ * handle adds one indirect call.
+ */
+struct OutRef {
+  void    (*begin)();
+  void    (*set)(bool on);
+  uint8_t pin;
+  bool    activeHigh;
+};
+
+template <class Out>
+constexpr OutRef outRef() { return { &Out::begin, &Out::set, Out::pin, Out::activeHigh }; }
+
+} // namespace Hal
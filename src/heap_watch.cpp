@@ -0,0 +1,86 @@
+// Scoped allocation counter + heap fragmentation (see heap_watch.h)
+#include "heap_watch.h"
+#include "config.h"
+
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <stdlib.h>
+
+namespace {
+  // Scope owner and depth: written only by the owning task, read by every
+  // allocation (a task that does not own the scope never matches)
+  volatile TaskHandle_t owner = nullptr;
+  uint16_t              depth = 0;
+
+  volatile uint32_t allocs = 0;
+  volatile uint32_t bytes  = 0;
+  bool              wrapped = false;
+  uint32_t          reported = 0;   // allocs at the last report()
+
+  inline void count(size_t n) {
+    if (owner && owner == xTaskGetCurrentTaskHandle()) {
+      allocs = allocs + 1;
+      bytes  = bytes + n;
+    }
+  }
+}
+
+// Link-time wrappers (-Wl,--wrap=malloc,...): every caller in the image,
+// including the prebuilt libraries, lands here first
+extern "C" {
+  void* __real_malloc(size_t n);
+  void* __real_calloc(size_t n, size_t size);
+  void* __real_realloc(void* p, size_t n);
+
+  void* __wrap_malloc(size_t n)              { count(n);        return __real_malloc(n); }
+  void* __wrap_calloc(size_t n, size_t size) { count(n * size); return __real_calloc(n, size); }
+  void* __wrap_realloc(void* p, size_t n)    { count(n);        return __real_realloc(p, n); }
+}
+
+namespace HeapWatch {
+
+Scope::Scope() {
+  if (depth++ == 0) owner = xTaskGetCurrentTaskHandle();
+}
+
+Scope::~Scope() {
+  if (--depth == 0) owner = nullptr;
+}
+
+void begin() {
+  const uint32_t before = allocs;
+  {
+    Scope probe;
+    void* volatile p = malloc(1);   // volatile: GCC may drop a malloc/free pair
+    free(p);
+  }
+  wrapped  = allocs != before;
+  reported = allocs;
+  if (!wrapped) LOGW("[Heap] Allocation counter not linked in (-Wl,--wrap=malloc missing)\n");
+}
+
+Stats stats() {
+  Stats s{};
+  s.wrapped  = wrapped;
+  s.allocs   = allocs;
+  s.bytes    = bytes;
+  s.freeB    = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+  s.minFreeB = heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+  s.largestB = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+  s.fragPct  = s.freeB ? (uint8_t)(100 - (uint64_t)s.largestB * 100 / s.freeB) : 0;
+  return s;
+}
+
+void report() {
+  const Stats s = stats();
+  LOGI("[Heap] free %lu B (min %lu), largest block %lu B, fragmentation %u%%, UI allocs %lu (%lu B)\n",
+       (unsigned long)s.freeB, (unsigned long)s.minFreeB, (unsigned long)s.largestB, (unsigned)s.fragPct,
+       (unsigned long)s.allocs, (unsigned long)s.bytes);
+  if (s.allocs != reported) {
+    LOGW("[Heap] UI path allocated %lu times since the last report\n", (unsigned long)(s.allocs - reported));
+    reported = s.allocs;
+  }
+}
+
+} // namespace HeapWatch
@@ -0,0 +1,44 @@
+#pragma once
+#include <Arduino.h>
+
+/*
+  Heap health for long-running units
+  - Allocation counter: malloc/calloc/realloc are wrapped at link time
+    (-Wl,--wrap=..., platformio.ini), so Arduino String, std containers and
+    operator new are all seen. Only allocations made by a task inside a
+    Scope are counted; the wrap costs one compare everywhere else.
+  - Fragmentation: free 8-bit heap vs. its largest free block, and the
+    low-water mark since boot.
+  The steady-state UI path runs inside a Scope and must stay at zero;
+  report() warns when it allocated since the previous report.
+*/
+namespace HeapWatch {
+
+/** Check that the wrap is linked in (logs a warning if not). Call early in setup(). */
+void begin();
+
+/** Count allocations of the calling task while the object lives. Scopes nest (one task at a time). */
+class Scope {
+public:
+  Scope();
+  ~Scope();
+  Scope(const Scope&) = delete;
+  Scope& operator=(const Scope&) = delete;
+};
+
+struct Stats {
+  bool     wrapped;        // the allocation counter is linked in
+  uint32_t allocs;         // allocations inside a Scope since boot
+  uint32_t bytes;          // bytes they asked for
+  uint32_t freeB;          // free 8-bit heap now
+  uint32_t minFreeB;       // lowest free heap since boot
+  uint32_t largestB;       // largest free block now
+  uint8_t  fragPct;        // 100 - largest / free
+};
+
+Stats stats();
+
+/** Log heap size, fragmentation and Scope allocations since the last report. */
+void report();
+
+} // namespace HeapWatch
@@ -1,24 +1,7 @@
-// Minimal relay HAL (active-LOW per board design)
+// Minimal relay HAL (same HeaterRelay type as HeaterCtl: one polarity)
 #include <Arduino.h>
 #include "heater.h"
 
-namespace {
-  bool g_on = false;
-}
-
-static inline void writeActiveLow(int pin, bool active) {
-  digitalWrite(pin, active ? LOW : HIGH);
-}
-
-void Heater::begin() {
-  pinMode(PIN, OUTPUT);
-  writeActiveLow(PIN, false);
-  g_on = false;
-}
-
-void Heater::set(bool on) {
-  writeActiveLow(PIN, on);
-  g_on = on;
-}
-
-bool Heater::get() { return g_on; }
+void Heater::begin()      { HeaterRelay::begin(); }
+void Heater::set(bool on) { HeaterRelay::set(on); }
+bool Heater::get()        { return HeaterRelay::isOn(); }
@@ -1,12 +1,12 @@
 #pragma once
 #include <Arduino.h>
-#include "pump.h"
+#include "actuators.h"
 
 namespace Heater {
-  // Jouw mapping: Heater Relay IN = GPIO26, Active-LOW
-  constexpr int PIN = 26;
+  // Jouw mapping: Heater Relay IN = GPIO26, Active-LOW (zie HeaterRelay, tank 0)
+  constexpr int PIN = HeaterRelay::pin;
 
   void begin();
-  void set(bool on);  // on=true -> relais aantrekken (active-LOW)
+  void set(bool on);  // on=true -> relais aantrekken (polariteit uit HeaterRelay)
   bool get();
-}
\ No newline at end of file
+}
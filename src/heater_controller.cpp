@@ -1,69 +1,92 @@
 #include "heater_controller.h"
-#include "config.h"
+#include "timers.h"
 
-namespace {
-  struct Cfg {
-    float    setpointC   = HEATER_SETPOINT_C;
-    float    hysteresisC = HEATER_HYST_C;
-    float    maxTempC    = HEATER_MAX_TEMP_C;
-    uint32_t minOnMs     = HEATER_MIN_ON_MS;
-    uint32_t minOffMs    = HEATER_MIN_OFF_MS;
-    bool     enabled     = true;
-  } cfg;
-
-  struct St {
-    bool     relayOn    = false;
-    uint32_t lastChange = 0;
-  } st;
+HeaterController::HeaterController(Hal::OutRef relay) : relay_(relay) {}
 
-  inline void driveRelay(bool on) {
-    digitalWrite(PIN_HEATER_RELAY, on ? HEATER_RELAY_ON : HEATER_RELAY_OFF);
-    st.relayOn   = on;
-    st.lastChange= millis();
-  }
-  inline bool canOn(uint32_t now)  { return (now - st.lastChange) >= cfg.minOffMs; }
-  inline bool canOff(uint32_t now) { return (now - st.lastChange) >= cfg.minOnMs;  }
+void HeaterController::driveRelay(bool on) {
+  relay_.set(on);
+  st_.relayOn    = on;
+  st_.lastChange = Timers::nowMs();
 }
 
-namespace HeaterCtl {
-
-void begin() {
-  pinMode(PIN_HEATER_RELAY, OUTPUT);
+void HeaterController::begin() {
+  relay_.begin();          // OFF level latched before the output is enabled
   driveRelay(false);
-  LOGI("[HeaterCtl] Relay pin=%d, active_high=%d\n", PIN_HEATER_RELAY, HEATER_ACTIVE_HIGH);
+  LOGI("[HeaterCtl] Relay pin=%d, active_high=%d\n", relay_.pin, relay_.activeHigh);
 }
 
-void setSetpoint(float c)  { cfg.setpointC   = constrain(c, 20.0f, 70.0f); }
-void setHysteresis(float c){ cfg.hysteresisC = constrain(c, 0.2f, 5.0f);   }
+namespace {
+  constexpr Temp::Raw SHEATH_MAX   = Temp::fromC(SHEATH_MAX_C);
+  constexpr Temp::Raw CASCADE_BAND = Temp::fromC(CASCADE_HYST_C);
+}
+
+void HeaterController::setSetpoint(float c)  { cfg_.setpoint   = Temp::fromC(constrain(c, 20.0f, 70.0f)); }
+void HeaterController::setHysteresis(float c){ cfg_.hysteresis = Temp::fromC(constrain(c, 0.2f, 5.0f));   }
 
-float getSetpointC()    { return cfg.setpointC; }
-float getHysteresisC()  { return cfg.hysteresisC; }
+// Control task: the only float math on the heater path
+void HeaterController::cascade(Temp::Raw bath, Temp::Raw sheath, uint64_t now) {
+  const bool  was = cascading();
+  float       dt  = (now - cascadeMs_) / 1000.0f;
+  cascadeMs_ = now;
+  sheath_    = sheath;
+  if (was != cascading()) {
+    LOGI("[HeaterCtl] Relay pin=%d: %s\n", relay_.pin, cascading() ? "cascade on the sheath probe" : "bath probe only");
+    integralC_ = 0.0f;
+    dt         = 0.0f;
+  }
+  if (!cascading() || bath == Temp::NONE) return;
 
-void enable(bool en) {
-  cfg.enabled = en;
-  if (!en && st.relayOn && canOff(millis())) driveRelay(false);
+  // PI with conditional integration: the I term only moves while the
+  // target is not pinned at a limit (no wind-up during the warm-up)
+  const float bathC = Temp::toC(bath);
+  const float sp    = effectiveSetpointC();
+  const float err   = sp - bathC;
+  const float maxC  = Temp::toC(SHEATH_MAX - CASCADE_BAND / 2);
+  const float raw   = sp + CASCADE_KP * err + integralC_;
+  if ((raw < maxC || err < 0.0f) && (raw > sp || err > 0.0f)) {
+    integralC_ = constrain(integralC_ + CASCADE_KI * err * dt, 0.0f, max(0.0f, maxC - sp));
+  }
+  sheathTarget_ = Temp::fromC(constrain(sp + CASCADE_KP * err + integralC_, bathC, maxC));
+  saturated_    = sheathTarget_ >= SHEATH_MAX - CASCADE_BAND / 2;
 }
-bool enabled() { return cfg.enabled; }
 
-void tick(float tc) {
-  const uint32_t now = millis();
+bool HeaterController::heating(uint64_t now) const {
+  // Off-times at the cap are the sheath cooling through the band plus the
+  // min-off hold; a longer pause is the power budget, not the cap
+  constexpr uint32_t CAP_CYCLE_OFF_MS = 30000;
+  return st_.relayOn || (cascading() && saturated_ && now - st_.lastChange < CAP_CYCLE_OFF_MS);
+}
 
+// Integer compares only (ISR-safe): the band is split so low + high = hysteresis
+bool HeaterController::wantsHeat(Temp::Raw t) const {
   // Safety and preconditions
-  if (!cfg.enabled || isnan(tc) || tc >= cfg.maxTempC) {
-    if (st.relayOn && canOff(now)) driveRelay(false);
-    return;
+  if (!cfg_.enabled || tripped_ || t == Temp::NONE || t >= cfg_.maxTemp) return false;
+
+  if (cascading()) {
+    if (sheath_ >= SHEATH_MAX) return false;
+    return st_.relayOn ? sheath_ <= sheathTarget_ + (CASCADE_BAND - CASCADE_BAND / 2)
+                       : sheath_ <  sheathTarget_ - CASCADE_BAND / 2;
   }
 
-  const float low  = cfg.setpointC - (cfg.hysteresisC * 0.5f);
-  const float high = cfg.setpointC + (cfg.hysteresisC * 0.5f);
+  const Temp::Raw sp = effectiveSetpointRaw();
+  return st_.relayOn ? t <= sp + (cfg_.hysteresis - cfg_.hysteresis / 2)
+                     : t <  sp - cfg_.hysteresis / 2;
+}
+
+// The relay itself is only driven from tick() (control task)
+void HeaterController::tick(Temp::Raw t, bool granted) {
+  const uint64_t now  = Timers::nowMs();
+  const bool     want = granted && wantsHeat(t);
 
-  if (!st.relayOn) {
-    if (tc < low && canOn(now))  driveRelay(true);
+  // A guard trip means the reading can't be trusted, and a sheath at the
+  // cap decomposes etchant: no hold time for either
+  if (tripped_ || (cascading() && sheath_ >= SHEATH_MAX)) {
+    if (st_.relayOn) driveRelay(false);
+    return;
+  }
+  if (!st_.relayOn) {
+    if (want && canOn(now))   driveRelay(true);
   } else {
-    if (tc > high && canOff(now)) driveRelay(false);
+    if (!want && canOff(now)) driveRelay(false);
   }
 }
-
-bool relayState() { return st.relayOn; }
-
-} // namespace HeaterCtl
\ No newline at end of file
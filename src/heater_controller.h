@@ -1,29 +1,133 @@
 #pragma once
 #include <Arduino.h>
+#include "config.h"
+#include "hal/out_pin.h"
+#include "temp_fixed.h"
 
-namespace HeaterCtl {
+/**
+ * Bang-bang heater controller with hysteresis and min-on/min-off holds,
+ * one instance per tank, driving its own relay output.
+ *
+ * Cascade mode, with a second probe on the heater sheath: an outer PI loop
+ * on the bath sets a sheath target (never above SHEATH_MAX_C), and the relay
+ * runs against the sheath, which answers in seconds instead of the tens of
+ * seconds the bath probe needs. The bath warms at full power while it is
+ * far off and the element backs off before the bath arrives. Without a
+ * valid sheath reading the relay runs against the bath as before.
+ *
+ * Temperatures are Temp::Raw (1/16 °C) inside: wantsHeat() and tick() are
+ * integer compares only, so they may run from a timer ISR. The float
+ * setters and getters convert at the edge; cascade()'s PI stays in float
+ * on the control task.
+ */
+class HeaterController {
+public:
+  explicit HeaterController(Hal::OutRef relay);
 
-/** Configure relay pin and default params (OFF at boot). */
-void begin();
+  /** Configure relay pin and default params (OFF at boot). */
+  void begin();
 
-/** Set target temperature (°C). Clamped to a safe range. */
-void setSetpoint(float c);
+  /** Set target temperature (°C). Clamped to a safe range. */
+  void setSetpoint(float c);
 
-/** Set total hysteresis band (°C), e.g. 0.8 → ±0.4 around setpoint. */
-void setHysteresis(float c);
+  /** Set total hysteresis band (°C), e.g. 0.8 → ±0.4 around setpoint. */
+  void setHysteresis(float c);
 
-/** Read back current configuration. */
-float getSetpointC();
-float getHysteresisC();
+  /** Read back current configuration. */
+  float     getSetpointC()   const { return Temp::toC(cfg_.setpoint); }
+  Temp::Raw getSetpointRaw() const { return cfg_.setpoint; }
 
-/** Arm/disarm the controller output. Disabling forces relay OFF (with min-off hold). */
-void enable(bool en);
-bool enabled();
+  /**
+   * Setpoint override from a running profile or standby (control task, every tick);
+   * NAN hands control back to the operator setpoint.
+   */
+  void setEffective(float c) { effective_ = isnan(c) ? Temp::NONE : Temp::fromC(c); }
+  /** The setpoint the controller regulates to: the override, else the operator's. */
+  Temp::Raw effectiveSetpointRaw() const { const Temp::Raw e = effective_; return e == Temp::NONE ? cfg_.setpoint : e; }
+  float     effectiveSetpointC()   const { return Temp::toC(effectiveSetpointRaw()); }
+  float     getHysteresisC()   const { return Temp::toC(cfg_.hysteresis); }
+  Temp::Raw getHysteresisRaw() const { return cfg_.hysteresis; }
 
-/** Feed the current temperature (°C). NAN is treated as fault → relay OFF. */
-void tick(float currentTempC);
+  /**
+   * Latched fault from the tank's ThermalGuard (control task, every tick).
+   * While set the relay drops on the next tick(), without the min-on hold.
+   */
+  void setTripped(bool t) { tripped_ = t; }
+  bool tripped() const { return tripped_; }
 
-/** Current relay state (true = ON). */
-bool relayState();
+  /**
+   * Outer loop of the cascade (control task, every tick before wantsHeat()):
+   * bath error -> sheath target. Temp::NONE sheath = plain bath control.
+   */
+  void cascade(Temp::Raw bath, Temp::Raw sheath, uint64_t now);
+  bool      cascading()       const { return sheath_ != Temp::NONE; }
+  Temp::Raw sheathRaw()       const { return sheath_; }
+  /** Sheath target of the outer loop, Temp::NONE when not cascading. */
+  Temp::Raw sheathTargetRaw() const { return cascading() ? sheathTarget_ : Temp::NONE; }
+  /**
+   * Heating, for the fault detectors: the relay is on, or it cycles on the
+   * sheath cap while the outer loop asks for full heat.
+   */
+  bool  heating(uint64_t now) const;
 
-} // namespace HeaterCtl
\ No newline at end of file
+  /** Arm/disarm the controller output. Disabling drops the relay on the next tick() (after the min-on hold). */
+  void enable(bool en) { cfg_.enabled = en; }
+  bool enabled() const { return cfg_.enabled; }
+
+  /**
+   * Controller decision for this temperature (hysteresis around the
+   * setpoint, or around the sheath target when cascading; safety cut-offs),
+   * without switching anything. Temp::NONE, over temperature, a guard trip
+   * or disabled → false.
+   */
+  bool wantsHeat(Temp::Raw current) const;
+
+  /**
+   * Feed the current temperature. Temp::NONE is treated as fault → relay OFF.
+   * The relay follows wantsHeat() while `granted` (mains power budget) and
+   * the min-on/min-off holds allow it.
+   * Called at a fixed rate by ControlTask; setters may be called from the
+   * loop task (plain 16/32-bit fields, read once per tick).
+   */
+  void tick(Temp::Raw current, bool granted = true);
+
+  /** True once the running min-on/min-off hold has expired. */
+  bool switchable(uint64_t now) const { return st_.relayOn ? canOff(now) : canOn(now); }
+
+  /** Milliseconds since the relay last switched. */
+  uint32_t msInState(uint64_t now) const { return (uint32_t)(now - st_.lastChange); }
+
+  /** Current relay state (true = ON). */
+  bool relayState() const { return st_.relayOn; }
+
+private:
+  void driveRelay(bool on);
+  bool canOn(uint64_t now)  const { return (now - st_.lastChange) >= (cascading() ? CASCADE_MIN_OFF_MS : cfg_.minOffMs); }
+  bool canOff(uint64_t now) const { return (now - st_.lastChange) >= (cascading() ? CASCADE_MIN_ON_MS : cfg_.minOnMs); }
+
+  const Hal::OutRef relay_;
+
+  struct Cfg {
+    Temp::Raw setpoint   = Temp::fromC(HEATER_SETPOINT_C);
+    Temp::Raw hysteresis = Temp::fromC(HEATER_HYST_C);
+    Temp::Raw maxTemp    = Temp::fromC(HEATER_MAX_TEMP_C);
+    uint32_t  minOnMs    = HEATER_MIN_ON_MS;
+    uint32_t  minOffMs   = HEATER_MIN_OFF_MS;
+    bool      enabled    = true;
+  } cfg_;
+
+  struct St {
+    bool     relayOn    = false;
+    uint64_t lastChange = 0;
+  } st_;
+
+  volatile Temp::Raw effective_ = Temp::NONE;
+  bool               tripped_   = false;
+
+  // Cascade (control task)
+  Temp::Raw      sheath_       = Temp::NONE;
+  Temp::Raw      sheathTarget_ = Temp::NONE;
+  float          integralC_    = 0.0f;   // outer loop I term, °C of sheath target
+  bool           saturated_    = false;
+  uint64_t       cascadeMs_    = 0;
+};
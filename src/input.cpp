@@ -0,0 +1,188 @@
+// Operator input driver: PCNT quadrature encoder + debounced push switches
+#include "input.h"
+#include "config.h"
+#include "spsc_queue.h"
+#include "scheduler.h"
+
+#include <driver/pcnt.h>
+#include <freertos/timers.h>
+
+// The encoder switch shares GPIO22 with the TFT backlight in the default
+// breadboard build flags; the display wins and the switch is left unused.
+#if defined(TFT_BL) && (TFT_BL == PIN_ENC_SW)
+  #define INPUT_HAS_ENC_SW 0
+#else
+  #define INPUT_HAS_ENC_SW 1
+#endif
+
+namespace {
+  using Input::Event;
+  using Input::EventType;
+  using Input::Key;
+
+  /* ---------- Encoder (PCNT) ---------- */
+  constexpr pcnt_unit_t ENC_UNIT = PCNT_UNIT_0;
+  constexpr int16_t     ENC_LIM  = 16000;   // counter wraps to 0 at ±LIM (ISR accumulates)
+
+  volatile int32_t encOverflow = 0;          // written by the PCNT ISR only
+  int32_t          encConsumed = 0;          // counts already turned into detents
+  int32_t          encLast     = 0;          // last value encCount() returned
+  uint32_t         lastRotMs   = 0;
+
+  void IRAM_ATTR pcntIsr(void*) {
+    uint32_t status = 0;
+    pcnt_get_event_status(ENC_UNIT, &status);
+    if (status & PCNT_EVT_H_LIM) encOverflow += ENC_LIM;
+    if (status & PCNT_EVT_L_LIM) encOverflow -= ENC_LIM;
+  }
+
+  // Overflow + live counter; retried if the ISR ran in between. The counter
+  // can also wrap at ±ENC_LIM after `ov` was read while the limit ISR has
+  // not booked it yet (pending, or running on the other core): that shows
+  // up as a jump of about ENC_LIM, which no hand on the knob produces
+  // between two loop passes. Report no movement then; the next call sees
+  // the booked overflow.
+  int32_t encCount() {
+    int32_t ov;
+    int16_t c = 0;
+    do {
+      ov = encOverflow;
+      pcnt_get_counter_value(ENC_UNIT, &c);
+    } while (ov != encOverflow);
+    const int32_t v = ov + c;
+    if (v - encLast > ENC_LIM / 2 || encLast - v > ENC_LIM / 2) return encLast;
+    encLast = v;
+    return v;
+  }
+
+  // PCNT counts on its own; this edge IRQ only wakes a sleeping main loop
+  void IRAM_ATTR encEdgeIsr() { Sched::wakeFromISR(); }
+
+  void encBegin() {
+    pcnt_config_t c = {};
+    c.unit           = ENC_UNIT;
+    c.counter_h_lim  = ENC_LIM;
+    c.counter_l_lim  = -ENC_LIM;
+    // Channel 0: edges on A, direction from B
+    c.channel        = PCNT_CHANNEL_0;
+    c.pulse_gpio_num = PIN_ENC_A;
+    c.ctrl_gpio_num  = PIN_ENC_B;
+    c.pos_mode       = PCNT_COUNT_DEC;
+    c.neg_mode       = PCNT_COUNT_INC;
+    c.lctrl_mode     = PCNT_MODE_REVERSE;
+    c.hctrl_mode     = PCNT_MODE_KEEP;
+    pcnt_unit_config(&c);
+    // Channel 1: edges on B, direction from A (x4 decoding)
+    c.channel        = PCNT_CHANNEL_1;
+    c.pulse_gpio_num = PIN_ENC_B;
+    c.ctrl_gpio_num  = PIN_ENC_A;
+    c.pos_mode       = PCNT_COUNT_INC;
+    c.neg_mode       = PCNT_COUNT_DEC;
+    pcnt_unit_config(&c);
+
+    pcnt_set_filter_value(ENC_UNIT, ENC_FILTER_CYCLES);
+    pcnt_filter_enable(ENC_UNIT);
+
+    pcnt_event_enable(ENC_UNIT, PCNT_EVT_H_LIM);
+    pcnt_event_enable(ENC_UNIT, PCNT_EVT_L_LIM);
+    pcnt_counter_pause(ENC_UNIT);
+    pcnt_counter_clear(ENC_UNIT);
+    pcnt_isr_service_install(0);
+    pcnt_isr_handler_add(ENC_UNIT, pcntIsr, nullptr);
+    pcnt_intr_enable(ENC_UNIT);
+    pcnt_counter_resume(ENC_UNIT);
+    attachInterrupt(PIN_ENC_A, encEdgeIsr, CHANGE);
+  }
+
+  // Map spin speed (detents/s) to a step multiplier: 1:1 when turning slowly,
+  // ramping linearly up to ENC_ACCEL_MAX for fast spins.
+  int16_t accelerate(int16_t detents, uint32_t dtMs) {
+    const uint32_t n   = (uint32_t)abs(detents);
+    const uint32_t dps = n * 1000UL / (dtMs ? dtMs : 1);
+    if (dps <= ENC_ACCEL_MIN_DPS) return detents;
+    uint32_t mult = ENC_ACCEL_MAX;
+    if (dps < ENC_ACCEL_MAX_DPS) {
+      mult = 1 + (ENC_ACCEL_MAX - 1) * (dps - ENC_ACCEL_MIN_DPS)
+                 / (ENC_ACCEL_MAX_DPS - ENC_ACCEL_MIN_DPS);
+    }
+    return (int16_t)(detents * (int16_t)mult);
+  }
+
+  /* ---------- Switches (GPIO IRQ + debounce timer) ---------- */
+  struct Switch {
+    uint8_t       pin;
+    Key           key;
+    TimerHandle_t tmr;
+    bool          pressed;   // debounced state, owned by the timer task
+  };
+
+  Switch switches[] = {
+#if INPUT_HAS_ENC_SW
+    { PIN_ENC_SW, Key::EncoderSw, nullptr, false },
+#endif
+    { PIN_BTN1,   Key::Button1,   nullptr, false },
+    { PIN_BTN2,   Key::Button2,   nullptr, false },
+  };
+
+  // Producer: FreeRTOS timer service task. Consumer: poll().
+  SpscQueue<Event, 16> events;
+  uint32_t             dropCount = 0;
+
+  void IRAM_ATTR switchIsr(void* arg) {
+    Switch* s = static_cast<Switch*>(arg);
+    BaseType_t woken = pdFALSE;
+    xTimerResetFromISR(s->tmr, &woken);   // (re)start the quiet period
+    if (woken) portYIELD_FROM_ISR();
+  }
+
+  // Runs once the line has been quiet for BTN_DEBOUNCE_MS.
+  void switchSettled(TimerHandle_t t) {
+    Switch* s = static_cast<Switch*>(pvTimerGetTimerID(t));
+    const bool pressed = digitalRead(s->pin) == LOW;
+    if (pressed == s->pressed) return;    // bounce only, no net change
+    s->pressed = pressed;
+    const Event e{ pressed ? EventType::Press : EventType::Release, s->key, 0, 0 };
+    if (!events.push(e)) dropCount++;
+    Sched::wake();
+  }
+
+  void switchesBegin() {
+    for (Switch& s : switches) {
+      pinMode(s.pin, INPUT_PULLUP);
+      s.pressed = digitalRead(s.pin) == LOW;
+      s.tmr = xTimerCreate("btn", pdMS_TO_TICKS(BTN_DEBOUNCE_MS), pdFALSE, &s, switchSettled);
+      attachInterruptArg(s.pin, switchIsr, &s, CHANGE);
+    }
+  }
+}
+
+namespace Input {
+
+void begin() {
+  encBegin();
+  switchesBegin();
+#if INPUT_HAS_ENC_SW
+  LOGI("[Input] Encoder A=%d B=%d SW=%d, buttons %d/%d\n",
+       PIN_ENC_A, PIN_ENC_B, PIN_ENC_SW, PIN_BTN1, PIN_BTN2);
+#else
+  LOGW("[Input] Encoder SW pin %d is TFT_BL in this build, switch disabled\n", PIN_ENC_SW);
+#endif
+}
+
+bool poll(Event& e) {
+  // Encoder first: whole detents accumulated in hardware since last poll
+  const int32_t delta   = encCount() - encConsumed;
+  const int16_t detents = (int16_t)(delta / ENC_COUNTS_PER_DETENT);
+  if (detents) {
+    const uint32_t now = millis();
+    encConsumed += detents * ENC_COUNTS_PER_DETENT;
+    e = Event{ EventType::Rotate, Key::Encoder, detents, accelerate(detents, now - lastRotMs) };
+    lastRotMs = now;
+    return true;
+  }
+  return events.pop(e);
+}
+
+uint32_t dropped() { return dropCount; }
+
+} // namespace Input
@@ -0,0 +1,34 @@
+#pragma once
+#include <Arduino.h>
+
+namespace Input {
+
+enum class Key : uint8_t { Encoder, EncoderSw, Button1, Button2 };
+enum class EventType : uint8_t { Rotate, Press, Release };
+
+struct Event {
+  EventType type;
+  Key       key;
+  int16_t   detents;  // Rotate: raw clicks since last event (+ = clockwise)
+  int16_t   steps;    // Rotate: detents scaled by the spin-speed acceleration
+};
+
+/**
+ * Configure the encoder on a PCNT unit (x4 quadrature, hardware glitch
+ * filter) and the push switches on GPIO interrupts with a one-shot
+ * FreeRTOS timer per switch for debouncing.
+ */
+void begin();
+
+/**
+ * Fetch the next input event. Encoder motion is read from the hardware
+ * counter here, so no detent is lost however long the caller was busy.
+ * Switch events come from a lock-free queue fed by the debounce timers.
+ * Returns false when nothing is pending.
+ */
+bool poll(Event& e);
+
+/** Number of switch events dropped because the queue was full. */
+uint32_t dropped();
+
+} // namespace Input
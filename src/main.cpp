@@ -1,59 +1,271 @@
 #include <Arduino.h>
 #include "config.h"
-#include "sensor_ds18b20.h"
-#include "heater_controller.h"
+#include "tanks.h"
+#include "control_task.h"
+#include "system_state.h"
 #include "ui/display_ui.h"
-#include "pump.h"
+#include "input.h"
+#include "scheduler.h"
+#include "timers.h"
+#include "power.h"
+#include "power_budget.h"
+#include "fleet.h"
+#include "pump_current.h"
+#include "standby.h"
+#include "heap_watch.h"
 
 /*
   ProtoEtch main loop
-  - Reads DS18B20 non-blocking
-  - Feeds heater controller (bang-bang w/ hysteresis & hold times)
-  - Triggers pump for 30 s on heater relay rising edge (non-blocking)
-  - Renders values on TFT_eSPI UI
+  - One or more tanks (TANK_COUNT), each with its own DS18B20, relay and pump
+  - Reads DS18B20s non-blocking
+  - Feeds each tank's heater controller (bang-bang w/ hysteresis & hold
+    times) from one fixed-period control task (ControlTask, CTRL_PERIOD_MS);
+    with a heater sheath probe it runs in cascade on the sheath
+  - Heater fault detectors per tank (ThermalGuard): no rise while heating,
+    stuck or jumping readings, disagreeing probes trip the heater in seconds
+  - Runs each tank's pump from its heater (Circulation): while heating, a
+    mixing run after it, and destratification pulses while idle
+  - Optional pump current monitor (PumpCurrent, PIN_PUMP_ISENSE): I2S ADC
+    DMA windows trip the pump on dry run, stall or a clogged inlet
+  - Encoder sets the setpoint, switches toggle heater / pump (tank 0); a
+    long Button2 press runs a ramp/soak recipe (Profile) on the control task
+  - Renders values on TFT_eSPI UI (status page or scrolling trend chart)
+  - Optional warm standby (Standby, STANDBY_IDLE_MS): idle baths hold a
+    lower temperature and are preheated in time for the next shift
+  - Tickless: all deadlines live on one timer wheel (Timers, 64-bit ms);
+    after each pass the loop task blocks until the next timer or an input
+    event (Sched), instead of spinning
+  - Optional fleet coordination (Fleet, FLEET_ENABLE): stations on one
+    circuit negotiate heater slots over MQTT to stay under the breaker
+    (own task on core 0, so a broker connect never blocks this loop)
+  - DFS: the CPU idles at PM_MIN_MHZ; PM locks boost it for display pushes
+    and keep APB / LEDC alive around 1-Wire and PWM output (Power)
+  - Heap watch (HeapWatch): the UI path draws from char buffers and must
+    not allocate; a link-time malloc wrap counts it, with fragmentation
 */
 
+// Tank on the status page and trend chart; the controls act on it
+static uint8_t shown = 0;
+
+// Trend chart sample (one column per TREND_SAMPLE_MS)
+static void trendTick(void*) {
+  const SystemState s = SharedState::read(shown);
+  DisplayUI::trendSample(s.tempRaw, s.setpointRaw, s.hysteresisRaw, s.relayOn);
+}
+
+// Diagnostics: power-mode residency (to line up with a current
+// measurement), control-tick timing, the mains power budget, the fleet,
+// the heater cascade, pump flow health, pump current, standby and the heap
+static void report(void*) {
+  Power::report();
+  ControlTask::report();
+  const PowerBudget::Stats pb = PowerBudget::stats();
+  LOGI("[Budget] cap %d W, peak %u W, deferred %lu, yields %lu, sheds %lu\n", POWER_BUDGET_W,
+       (unsigned)pb.peakW, (unsigned long)pb.deferred, (unsigned long)pb.yields, (unsigned long)pb.sheds);
+  Fleet::report();
+  for (uint8_t i = 0; i < Tanks::COUNT; ++i) {
+    const SystemState s = SharedState::read(i);
+    if (s.sheathTargetRaw != Temp::NONE) {
+      LOGI("[HeaterCtl] %s: cascade, sheath %.1f C -> %.1f C (cap %.0f C), bath %.1f C\n", Tanks::at(i).name,
+           Temp::toC(s.sheathRaw), Temp::toC(s.sheathTargetRaw), SHEATH_MAX_C, Temp::toC(s.tempRaw));
+    }
+    const Pump& p = Tanks::at(i).pump;
+    if (!p.hasTach()) continue;
+    const Pump::Flow f = p.flow();
+    LOGI("[Pump] %s: %s, %u/%u rpm at duty %u, load %u%%\n", Tanks::at(i).name, Pump::name(f.state),
+         (unsigned)f.rpm, (unsigned)f.targetRpm, (unsigned)f.duty, (unsigned)f.loadPct);
+  }
+  PumpCurrent::report();
+  Standby::report();
+  HeapWatch::report();
+  const Sched::Stats ss = Sched::stats();
+  const Timers::Stats ts = Timers::stats();
+  LOGI("[Power] loop busy %lu ms, idle %lu ms; timers %u armed (peak %u/%d)\n",
+       (unsigned long)ss.busyMs, (unsigned long)ss.idleMs,
+       (unsigned)ts.inUse, (unsigned)ts.peak, TIMERS_MAX);
+}
+
 void setup() {
   Serial.begin(115200);
   delay(200);
 
   LOGI("\n[ProtoEtch] Booting...\n");
+  Sched::begin();         // loop task receives the wake-up notifications
+  Power::begin();         // DFS + PM locks, before any module takes one
+  HeapWatch::begin();     // allocation counter self-check
+  Timers::begin();        // before any module arms a timer
 
-  TempSensor::begin();
-  HeaterCtl::begin();
-  Pump::begin();          // init pomp driver (LEDC, pin 25 bv.)
+  Tanks::begin();         // probes, relays (OFF), pumps (LEDC)
+  PumpCurrent::begin(Tanks::at(PUMP_ISENSE_TANK).pump);   // I2S ADC DMA (PIN_PUMP_ISENSE)
+  ControlTask::begin();   // fixed-rate sample -> control -> relay, all tanks
+  Fleet::begin();         // WiFi + MQTT heater slots (FLEET_ENABLE)
+  Standby::begin();       // idle hold + shift preheat (STANDBY_IDLE_MS), SNTP over the fleet WiFi
   DisplayUI::begin();     // init TFT and draw static UI
+  if (Tanks::COUNT > 1) DisplayUI::showTank(Tanks::at(shown).name);
+  Input::begin();         // encoder (PCNT) + buttons
+
+  Timers::every(TREND_SAMPLE_MS, trendTick);
+  Timers::every(PM_REPORT_MS, report);
 }
 
-void loop() {
-  // 1) Sensor update
-  TempSensor::update();
-
-  // 2) Regelaar
-  const float tC = TempSensor::latestC();
-  HeaterCtl::tick(tC);
-
-  // 3) Rising-edge detectie op heater-relais -> pomp 30 s aan
-  static bool lastRelay = false;
-  const bool relayNow = HeaterCtl::relayState();   // true = aan
-  if (relayNow && !lastRelay) {
-    Pump::onFor(30000); // 30 s non-blocking
+// Start the default ramp/soak recipe, or stop the running one
+static void toggleProfile(Tank& tank) {
+  if (tank.profile.running()) {
+    tank.profile.stop();
+    return;
   }
-  lastRelay = relayNow;
-
-  // 4) Pomp timer afhandelen
-  Pump::update();
-
-  // 5) UI refresh
-  static uint32_t lastUi = 0;
-  const uint32_t now = millis();
-  if (now - lastUi >= 250) {
-    DisplayUI::update(
-      tC,
-      HeaterCtl::getSetpointC(),
-      HeaterCtl::relayState(),
-      Pump::isOn()
-    );
-    lastUi = now;
+  const Profile::Recipe& r = Profile::builtin(PROFILE_DEFAULT);
+  if (!tank.profile.start(r)) return;
+  tank.heater.enable(true);
+  LOGI("[Input] %s profile %s\n", tank.name, r.name);
+}
+
+// Heater key (Button1 held, or the encoder switch where it is wired):
+// clears a latched heater fault on whichever tank has one, otherwise
+// switches the shown tank's heater on / off
+static void heaterKey(Tank& tank) {
+  bool cleared = false;
+  for (uint8_t i = 0; i < Tanks::COUNT; ++i) {
+    Tank& t = Tanks::at(i);
+    if (t.guard.fault() == ThermalGuard::Fault::None) continue;
+    t.guard.requestReset();   // the detectors start over, the heater stays enabled
+    LOGI("[Input] %s heater fault cleared\n", t.name);
+    cleared = true;
   }
+  if (cleared) return;
+  tank.heater.enable(!tank.heater.enabled());
+  LOGI("[Input] %s heater %s\n", tank.name, tank.heater.enabled() ? "enabled" : "disabled");
+}
+
+// Pump key (Button1): restarts a tripped pump on whichever tank has one,
+// otherwise starts / stops a manual run on the shown tank
+static void pumpKey(Tank& tank) {
+  bool restarted = false;
+  for (uint8_t i = 0; i < Tanks::COUNT; ++i) {
+    Tank& t = Tanks::at(i);
+    if (t.pump.tripped() == Pump::Trip::None) continue;
+    t.pump.resetTrip();
+    t.circ.restart();
+    restarted = true;
+  }
+  if (!restarted) tank.circ.toggleManual();
+}
+
+// Button1 + Button2 together: the next tank on the status page and controls
+static void nextTank() {
+  shown = (shown + 1) % Tanks::COUNT;
+  DisplayUI::showTank(Tanks::at(shown).name);
+  LOGI("[Input] Controls on %s\n", Tanks::at(shown).name);
+}
+
+// Operator input: encoder = setpoint (stops a profile), Button1 = manual
+// pump run on/off (restarts a tripped pump), held = heater enable (clears a
+// heater fault), Button2 = status page / trend chart, held = start/stop
+// profile. The encoder switch, if it has its own pin (not the backlight's
+// GPIO22), is a second heater key. The switches act on release.
+// The controls act on the tank shown on the status page; with several
+// tanks, pressing both buttons together shows the next one. Fault and trip
+// resets act on every tank that has one, so no bath stays latched off.
+static void handleInput() {
+  static uint64_t btn1DownMs = 0;   // 0 = not held (or its press woke the panel, or a chord took it)
+  static uint64_t btn2DownMs = 0;
+  Input::Event e;
+  while (Input::poll(e)) {
+    Tank& tank = Tanks::at(shown);
+    // Any input wakes the display and ends standby; the one that woke a
+    // sleeping panel is consumed
+    Standby::activity();
+    const bool wasAsleep = DisplayUI::asleep();
+    DisplayUI::wake();
+    if (wasAsleep) continue;
+    if (e.type == Input::EventType::Rotate) {
+      // From the profile's ramped setpoint (the operator takes over), never
+      // from a standby temperature that is about to be dropped
+      const float fromC = tank.profile.running() ? tank.heater.effectiveSetpointC() : tank.heater.getSetpointC();
+      tank.profile.stop();
+      tank.heater.setSetpoint(fromC + e.steps * INPUT_SETPOINT_STEP_C);
+      continue;
+    }
+    if (e.type == Input::EventType::Release && e.key == Input::Key::Button1 && btn1DownMs) {
+      const bool held = Timers::nowMs() - btn1DownMs >= INPUT_LONG_PRESS_MS;
+      btn1DownMs = 0;
+      if (held) heaterKey(tank);
+      else      pumpKey(tank);
+      continue;
+    }
+    if (e.type == Input::EventType::Release && e.key == Input::Key::Button2 && btn2DownMs) {
+      const bool held = Timers::nowMs() - btn2DownMs >= INPUT_LONG_PRESS_MS;
+      btn2DownMs = 0;
+      if (held) toggleProfile(tank);
+      else      DisplayUI::showTrend(!DisplayUI::trendShown());
+      continue;
+    }
+    if (e.type != Input::EventType::Press) continue;
+    switch (e.key) {
+      case Input::Key::EncoderSw:
+        heaterKey(tank);
+        break;
+      case Input::Key::Button1:
+        if (Tanks::COUNT > 1 && btn2DownMs) {
+          btn2DownMs = 0;
+          nextTank();
+          break;
+        }
+        btn1DownMs = max<uint64_t>(Timers::nowMs(), 1);   // acts on release: short or held
+        break;
+      case Input::Key::Button2:
+        if (Tanks::COUNT > 1 && btn1DownMs) {
+          btn1DownMs = 0;
+          nextTank();
+          break;
+        }
+        btn2DownMs = max<uint64_t>(Timers::nowMs(), 1);   // acts on release: short or held
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+void loop() {
+  // 0) Expired timers: sensor state machine, circulation runs, UI idle, ...
+  Timers::run();
+
+  // 1) Operator input
+  handleInput();
+
+  // 2) Regelaar draait in ControlTask; hier per tank de alarmen en de
+  //    circulatie, elk op basis van één consistente snapshot
+  bool job = false;
+  for (uint8_t i = 0; i < Tanks::COUNT; ++i) {
+    Tank& tank = Tanks::at(i);
+    tank.pump.poll();   // finish a current-monitor trip
+    job |= tank.profile.running() || tank.circ.mode() == Circulation::Mode::Manual;
+    const SystemState t = SharedState::read(i);
+    // Alarm conditions (no valid reading, over-temperature, heater fault, pump trip) keep the panel awake
+    if (t.tempRaw == Temp::NONE || t.tempRaw >= Temp::fromC(HEATER_MAX_TEMP_C) || t.fault || t.pumpTrip) {
+      DisplayUI::wake();
+    }
+
+    // 3) Pomp volgt het heater-relais (aan tijdens verwarmen, daarna mengen),
+    //    het toerental volgt de temperatuurfout
+    tank.circ.update(t.relayOn, t.heaterEnabled,
+                     t.tempRaw == Temp::NONE ? NAN : Temp::toC(t.setpointRaw - t.tempRaw));
+  }
+  const SystemState s = SharedState::read(shown);
+
+  // 4) UI refresh: every pass ends here after something happened; the value
+  //    cache keeps SPI traffic limited to fields that actually changed. Only
+  //    operator jobs on any tank keep the panel lit (same "busy" as
+  //    Standby), not the pumps' automatic runs
+  DisplayUI::update(
+    s.tempRaw,
+    s.setpointRaw,
+    s.relayOn,
+    s.pumpOn,
+    job
+  );
+
+  // 5) Sleep until the next timer or an input event
+  Sched::idle(Timers::msUntilNext());
 }
@@ -0,0 +1,106 @@
+// Dynamic frequency scaling + PM locks (ESP-IDF esp_pm)
+#include "power.h"
+#include "config.h"
+
+#include <sdkconfig.h>
+#include <esp_pm.h>
+#include <esp_timer.h>
+
+namespace {
+  using Power::Lock;
+  constexpr int N = (int)Lock::COUNT;
+
+  const char* const NAMES[N] = { "display", "onewire", "pump", "backlight" };
+
+  struct Slot {
+    esp_pm_lock_handle_t freq  = nullptr;  // CPU_FREQ_MAX or APB_FREQ_MAX
+    esp_pm_lock_handle_t awake = nullptr;  // NO_LIGHT_SLEEP (bus/PWM locks)
+    uint16_t             depth = 0;
+    int64_t              since = 0;
+  } slots[N];
+
+  Power::Stats st{};
+  portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+
+  void create(Lock l, esp_pm_lock_type_t freqType, bool noSleep) {
+    Slot& s = slots[(int)l];
+    if (esp_pm_lock_create(freqType, 0, NAMES[(int)l], &s.freq) != ESP_OK) s.freq = nullptr;
+    if (noSleep && esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, NAMES[(int)l], &s.awake) != ESP_OK) {
+      s.awake = nullptr;
+    }
+  }
+}
+
+namespace Power {
+
+void begin() {
+#if CONFIG_PM_ENABLE
+  esp_pm_config_esp32_t cfg = {};
+  cfg.max_freq_mhz       = PM_MAX_MHZ;
+  cfg.min_freq_mhz       = PM_MIN_MHZ;
+  cfg.light_sleep_enable = PM_LIGHT_SLEEP;
+  esp_err_t err = esp_pm_configure(&cfg);
+  if (err != ESP_OK && cfg.light_sleep_enable) {
+    // Light sleep needs FreeRTOS tickless idle in the SDK config
+    cfg.light_sleep_enable = false;
+    err = esp_pm_configure(&cfg);
+  }
+  st.dfs        = err == ESP_OK;
+  st.lightSleep = st.dfs && cfg.light_sleep_enable;
+  if (st.dfs) {
+    create(Lock::Display, ESP_PM_CPU_FREQ_MAX, false);
+    create(Lock::OneWire, ESP_PM_APB_FREQ_MAX, true);
+    create(Lock::Pump,    ESP_PM_APB_FREQ_MAX, true);
+    create(Lock::Backlight, ESP_PM_APB_FREQ_MAX, true);
+    LOGI("[Power] DFS %d..%d MHz, light sleep %s\n", PM_MIN_MHZ, PM_MAX_MHZ,
+         st.lightSleep ? "on" : "off");
+  } else {
+    LOGW("[Power] esp_pm_configure failed (%d), running at fixed clock\n", (int)err);
+  }
+#else
+  LOGW("[Power] CONFIG_PM_ENABLE not set in SDK, running at fixed clock\n");
+#endif
+}
+
+void acquire(Lock l) {
+  Slot& s = slots[(int)l];
+  portENTER_CRITICAL(&mux);
+  const bool first = s.depth++ == 0;
+  if (first) { s.since = esp_timer_get_time(); st.takes[(int)l]++; }
+  portEXIT_CRITICAL(&mux);
+  if (!first) return;
+  if (s.freq)  esp_pm_lock_acquire(s.freq);
+  if (s.awake) esp_pm_lock_acquire(s.awake);
+}
+
+void release(Lock l) {
+  Slot& s = slots[(int)l];
+  portENTER_CRITICAL(&mux);
+  const bool last = s.depth && --s.depth == 0;
+  if (last) st.heldUs[(int)l] += esp_timer_get_time() - s.since;
+  portEXIT_CRITICAL(&mux);
+  if (!last) return;
+  if (s.awake) esp_pm_lock_release(s.awake);
+  if (s.freq)  esp_pm_lock_release(s.freq);
+}
+
+Stats stats() {
+  portENTER_CRITICAL(&mux);
+  Stats out = st;
+  const int64_t now = esp_timer_get_time();
+  for (int i = 0; i < N; ++i) if (slots[i].depth) out.heldUs[i] += now - slots[i].since;
+  portEXIT_CRITICAL(&mux);
+  return out;
+}
+
+void report() {
+  const Stats s = stats();
+  const double up = (double)esp_timer_get_time();
+  LOGI("[Power] DFS=%d LS=%d uptime=%.0fs", s.dfs, s.lightSleep, up / 1e6);
+  for (int i = 0; i < N; ++i) {
+    LOGI(" %s=%.2f%%(%u)", NAMES[i], 100.0 * (double)s.heldUs[i] / up, (unsigned)s.takes[i]);
+  }
+  LOGI("\n");
+}
+
+} // namespace Power
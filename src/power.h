@@ -0,0 +1,50 @@
+#pragma once
+#include <Arduino.h>
+
+/*
+  Power management (ESP-IDF esp_pm)
+  - Dynamic frequency scaling: CPU idles at PM_MIN_MHZ, boosts to PM_MAX_MHZ
+  - Automatic light sleep when every task is blocked (if the SDK allows it)
+  - PM locks around timing-critical work:
+      Display : CPU at max while pushing pixels
+      OneWire : APB fixed, no light sleep during a 1-Wire transaction
+      Pump    : APB fixed, no light sleep while the pump LEDC output runs
+      Backlight: same for the backlight LEDC output (panel awake)
+  Residency per lock is accounted so the modes can be compared against a
+  current measurement (report()).
+*/
+namespace Power {
+
+enum class Lock : uint8_t { Display, OneWire, Pump, Backlight, COUNT };
+
+/** Configure DFS / light sleep and create the PM locks. Call early in setup(). */
+void begin();
+
+/** Take / drop a lock. Calls nest; the lock is released on the last release(). */
+void acquire(Lock l);
+void release(Lock l);
+
+/** Scoped lock: held for the lifetime of the object. */
+class Hold {
+public:
+  explicit Hold(Lock l) : l_(l) { acquire(l_); }
+  ~Hold() { release(l_); }
+  Hold(const Hold&) = delete;
+  Hold& operator=(const Hold&) = delete;
+private:
+  Lock l_;
+};
+
+struct Stats {
+  bool     dfs;                              // esp_pm_configure() accepted
+  bool     lightSleep;                       // automatic light sleep enabled
+  uint64_t heldUs[(int)Lock::COUNT];         // total time each lock was held
+  uint32_t takes[(int)Lock::COUNT];          // number of acquisitions
+};
+
+Stats stats();
+
+/** Log lock residency since boot (percent of uptime per mode). */
+void report();
+
+} // namespace Power
@@ -0,0 +1,80 @@
+// Mains power budget arbiter (see power_budget.h)
+#include "power_budget.h"
+
+namespace {
+  PowerBudget::Stats st{};
+  constexpr uint8_t MAX_LOADS = 8;
+}
+
+namespace PowerBudget {
+
+void arbitrate(const Request* req, uint8_t n, uint16_t fixedW, const Policy& p, bool* grant) {
+  if (n > MAX_LOADS) n = MAX_LOADS;
+
+  // Priority order: largest deficit first (insertion sort, n is tiny)
+  uint8_t order[MAX_LOADS];
+  for (uint8_t i = 0; i < n; ++i) {
+    uint8_t k = i;
+    while (k && req[order[k - 1]].deficitC < req[i].deficitC) { order[k] = order[k - 1]; --k; }
+    order[k] = i;
+  }
+
+  const int32_t budget = (int32_t)p.capW - fixedW;
+  int32_t used = 0;
+
+  // 1) Heaters held on by their min-on hold draw power whatever we decide
+  for (uint8_t i = 0; i < n; ++i) {
+    grant[i] = req[i].on && !req[i].switchable && req[i].want;
+    if (req[i].on && !req[i].switchable) used += req[i].watts;
+  }
+
+  // 2) Other running heaters keep their slot while it fits, else are shed
+  for (uint8_t k = 0; k < n; ++k) {
+    const uint8_t i = order[k];
+    if (!req[i].on || !req[i].switchable || !req[i].want) continue;
+    if (used + req[i].watts <= budget) {
+      grant[i] = true;
+      used += req[i].watts;
+    } else {
+      st.sheds++;
+    }
+  }
+
+  // 3) Waiting heaters in priority order; take a slot from a lower-priority
+  //    heater whose time slice is used up if there is no room
+  for (uint8_t k = 0; k < n; ++k) {
+    const uint8_t i = order[k];
+    if (!req[i].want || req[i].on || !req[i].switchable) continue;
+    if (used + req[i].watts > budget) {
+      // Pick yielders lowest priority first; commit only if they free enough
+      uint8_t victims[MAX_LOADS], nv = 0;
+      int32_t freed = 0;
+      for (uint8_t m = n; m-- > 0 && used - freed + req[i].watts > budget;) {
+        const uint8_t j = order[m];
+        if (!grant[j] || !req[j].on || !req[j].switchable) continue;
+        if (req[j].inStateMs < p.sliceMs) continue;
+        if (req[i].deficitC < req[j].deficitC + p.yieldMarginC) continue;
+        victims[nv++] = j;
+        freed += req[j].watts;
+      }
+      if (used - freed + req[i].watts <= budget) {
+        for (uint8_t v = 0; v < nv; ++v) grant[victims[v]] = false;
+        used -= freed;
+        st.yields += nv;
+      }
+    }
+    if (used + req[i].watts <= budget) {
+      grant[i] = true;
+      used += req[i].watts;
+    } else {
+      st.deferred++;
+    }
+  }
+
+  const int32_t total = used + fixedW;
+  if (total > st.peakW) st.peakW = (uint16_t)total;
+}
+
+Stats stats() { return st; }
+
+} // namespace PowerBudget
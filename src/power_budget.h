@@ -0,0 +1,48 @@
+#pragma once
+// Mains power budget across the heaters and pumps on one supply
+//
+// Every control tick each heater states whether it wants heat; the arbiter
+// grants on-periods so the total draw (heaters granted + pumps running)
+// stays under the cap (POWER_BUDGET_W). Priority goes to the bath furthest below its
+// setpoint; a heater that has run for POWER_SLICE_MS yields to a waiting
+// bath that is further behind, so baths take turns instead of tripping the
+// breaker together. Pure logic (no Arduino dependency), runs on any host.
+
+#include <stdint.h>
+
+namespace PowerBudget {
+
+/** One heater's view for this tick. */
+struct Request {
+  bool     want;        // controller wants heat (hysteresis + safety)
+  bool     on;          // relay currently on
+  bool     switchable;  // min-on/min-off hold expired
+  float    deficitC;    // setpoint - temperature (priority; larger first)
+  uint32_t inStateMs;   // time since the relay last switched
+  uint16_t watts;       // heater rating
+};
+
+/** Supply limit and time-slice policy. */
+struct Policy {
+  uint16_t capW;          // total allowed draw
+  uint32_t sliceMs;       // minimum run before a heater can be asked to yield
+  float    yieldMarginC;  // waiting bath must be this much further behind
+};
+
+struct Stats {
+  uint32_t deferred;    // ticks a heater wanted heat but got no budget
+  uint32_t yields;      // time-slice hand-overs
+  uint32_t sheds;       // running heaters dropped because the budget shrank
+  uint16_t peakW;       // highest granted draw (heaters + fixed loads)
+};
+
+/**
+ * Decide which heaters may be on. `fixedW` is the draw that is not
+ * arbitrated (running pumps). grant[i] is set for every request; a heater
+ * that cannot switch yet keeps its current state.
+ */
+void arbitrate(const Request* req, uint8_t n, uint16_t fixedW, const Policy& p, bool* grant);
+
+Stats stats();
+
+} // namespace PowerBudget
@@ -0,0 +1,120 @@
+// Ramp/soak setpoint profiles (control task) and the recipe table
+#include "profile.h"
+
+namespace {
+  // Etchant warm-up recipes: a fast ramp where the bath can follow, a slow
+  // approach to the working temperature, then hold
+  const Profile::Recipe BUILTIN[] = {
+    { "NaPS 45",   2, { { 350, 200, 5 }, { 450, 50, 0 } } },   // sodium persulfate
+    { "FeCl3 40",  2, { { 300, 200, 5 }, { 400, 50, 0 } } },   // ferric chloride
+    { "Tin 30",    1, { { 300, 50, 0 } } },                    // electroless tin, gentle
+  };
+  constexpr uint8_t BUILTIN_N = sizeof(BUILTIN) / sizeof(BUILTIN[0]);
+  static_assert(PROFILE_DEFAULT < BUILTIN_N, "PROFILE_DEFAULT must index a built-in recipe");
+
+  constexpr float MIN_C = 20.0f;   // same range as HeaterController::setSetpoint()
+}
+
+uint8_t Profile::builtinCount() { return BUILTIN_N; }
+
+const Profile::Recipe& Profile::builtin(uint8_t i) { return BUILTIN[i < BUILTIN_N ? i : 0]; }
+
+bool Profile::parse(const char* text, const char* name, Recipe& out) {
+  out = {};
+  strlcpy(out.name, name, sizeof(out.name));
+  const char* p = text;
+  while (*p) {
+    if (out.count == PROFILE_MAX_SEGMENTS) return false;
+    char* end = nullptr;
+    const float t = strtof(p, &end);
+    if (end == p || *end != '/') return false;
+    p = end + 1;
+    const float r = strtof(p, &end);
+    if (end == p || *end != '/') return false;
+    p = end + 1;
+    const long s = strtol(p, &end, 10);
+    if (end == p || (*end && *end != ',')) return false;
+    p = *end ? end + 1 : end;
+
+    if (t < MIN_C || t >= HEATER_MAX_TEMP_C || r < 0.0f || r > 600.0f || s < 0 || s > UINT16_MAX) return false;
+    Segment& g = out.seg[out.count++];
+    g.targetDeciC      = (int16_t)lroundf(t * 10.0f);
+    g.rateCentiCPerMin = (uint16_t)lroundf(r * 100.0f);
+    g.soakMin          = (uint16_t)s;
+  }
+  return out.count > 0;
+}
+
+bool Profile::start(const Recipe& r) {
+  if (cmd_.load(std::memory_order_acquire) != Cmd::None || r.count == 0) return false;
+  pending_ = r;
+  cmd_.store(Cmd::Start, std::memory_order_release);
+  return true;
+}
+
+void Profile::stop() { cmd_.store(Cmd::Stop, std::memory_order_release); }
+
+void Profile::enterSegment(uint8_t i) {
+  seg_    = i;
+  soakMs_ = 0;
+  state_  = State::Ramp;
+  LOGI("[Profile] %s: segment %u/%u -> %.1f C at %.2f C/min, soak %u min\n", recipe_.name, i + 1,
+       recipe_.count, targetC(), recipe_.seg[i].rateCentiCPerMin / 100.0f, recipe_.seg[i].soakMin);
+}
+
+float Profile::tick(float bathC, float fallbackC, uint64_t now) {
+  switch (cmd_.exchange(Cmd::None, std::memory_order_acq_rel)) {
+    case Cmd::Start:
+      recipe_ = pending_;
+      effC_   = isnan(bathC) ? fallbackC : constrain(bathC, MIN_C, HEATER_MAX_TEMP_C);
+      lastMs_ = now;
+      enterSegment(0);
+      break;
+    case Cmd::Stop:
+      if (state_ != State::Idle) LOGI("[Profile] %s stopped\n", recipe_.name);
+      state_ = State::Idle;
+      break;
+    case Cmd::None:
+      break;
+  }
+  if (state_ == State::Idle) return NAN;
+
+  const uint32_t dt = (uint32_t)(now - lastMs_);
+  lastMs_ = now;
+  const Segment& g   = recipe_.seg[seg_];
+  const float target = targetC();
+
+  if (state_ == State::Ramp) {
+    const float dir = target >= effC_ ? 1.0f : -1.0f;
+    // Guaranteed ramp: hold while the bath lags the ramped setpoint
+    const bool lagging = !isnan(bathC) && (effC_ - bathC) * dir > PROFILE_GUARANTEE_C;
+    if (g.rateCentiCPerMin == 0) {
+      effC_ = target;
+    } else if (!lagging) {
+      const float step = g.rateCentiCPerMin / 100.0f * dt / 60000.0f;
+      effC_ = fabsf(target - effC_) <= step ? target : effC_ + dir * step;
+    }
+    if (effC_ == target) state_ = State::Soak;
+  } else if (state_ == State::Soak) {
+    if (!isnan(bathC) && fabsf(bathC - target) <= PROFILE_GUARANTEE_C) soakMs_ += dt;
+    if (soakMs_ >= g.soakMin * 60000UL) {
+      if (seg_ + 1 < recipe_.count) {
+        enterSegment(seg_ + 1);
+      } else {
+        state_ = State::Done;
+        LOGI("[Profile] %s done, holding %.1f C\n", recipe_.name, target);
+      }
+    }
+  }
+  return effC_;
+}
+
+const char* Profile::name(State s) {
+  switch (s) {
+    case State::Idle: return "idle";
+    case State::Ramp: return "ramp";
+    case State::Soak: return "soak";
+    case State::Done: return "done";
+  }
+  return "?";
+}
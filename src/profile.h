@@ -0,0 +1,80 @@
+#pragma once
+#include <Arduino.h>
+#include <atomic>
+#include "config.h"
+
+/**
+ * Ramp/soak setpoint profile for one tank, run by the control task next to
+ * HeaterController::tick(). A step to a far setpoint overshoots badly with
+ * this slow plant; a ramp lets the bath follow instead.
+ *
+ * A recipe is up to PROFILE_MAX_SEGMENTS segments of 6 bytes: ramp to the
+ * target at a rate (0 = step), then soak. The ramp waits while the bath
+ * lags by more than PROFILE_GUARANTEE_C, and soak time only counts within
+ * that band of the target. After the last segment the profile holds its
+ * target until stopped. Recipes come from the built-in table or from text:
+ * "35/2/10,45/0.5/0" = target °C / ramp °C per min / soak min, per segment.
+ *
+ * start()/stop() are called from the loop task and applied on the next
+ * tick; everything else runs on the control task.
+ */
+class Profile {
+public:
+  struct Segment {
+    int16_t  targetDeciC;       // 0.1 °C
+    uint16_t rateCentiCPerMin;  // 0.01 °C/min, 0 = step
+    uint16_t soakMin;
+  };
+
+  struct Recipe {
+    char    name[12];
+    uint8_t count;
+    Segment seg[PROFILE_MAX_SEGMENTS];
+  };
+
+  enum class State : uint8_t { Idle, Ramp, Soak, Done };
+
+  /** Built-in recipes (flash). */
+  static uint8_t       builtinCount();
+  static const Recipe& builtin(uint8_t i);
+
+  /** Parse "target/rate/soak,..." into `out`; false on a malformed or out-of-range recipe. */
+  static bool parse(const char* text, const char* name, Recipe& out);
+
+  /** Queue a recipe for the next tick (loop task). False while a command is still pending. */
+  bool start(const Recipe& r);
+  /** Queue a stop; the operator setpoint takes over again. */
+  void stop();
+
+  /**
+   * Advance the profile (control task). Returns the effective setpoint, or
+   * NAN when no profile runs. `fallbackC` is the operator setpoint, the
+   * start point when the bath temperature is unknown.
+   */
+  float tick(float bathC, float fallbackC, uint64_t now);
+
+  State   state()   const { return state_; }
+  bool    running() const { return state_ != State::Idle; }
+  /** Segment index (0-based) of a running profile. */
+  uint8_t segment() const { return seg_; }
+  const char* name() const { return recipe_.name; }
+
+  static const char* name(State s);
+
+private:
+  enum class Cmd : uint8_t { None, Start, Stop };
+
+  void enterSegment(uint8_t i);
+  float targetC() const { return recipe_.seg[seg_].targetDeciC / 10.0f; }
+
+  std::atomic<Cmd> cmd_{Cmd::None};
+  Recipe           pending_{};        // written by start() before cmd_ is set
+
+  // Control task
+  Recipe           recipe_{};
+  volatile State   state_  = State::Idle;
+  volatile uint8_t seg_    = 0;
+  float            effC_   = NAN;
+  uint64_t         lastMs_ = 0;
+  uint32_t         soakMs_ = 0;
+};
@@ -1,38 +1,266 @@
-// Simple PWM pump driver using ESP32 LEDC
+// Simple PWM pump driver using ESP32 LEDC, with an optional FG tach speed loop
 #include <Arduino.h>
 #include "pump.h"
+#include "config.h"
+#include "power.h"
+#include "scheduler.h"
+
+#include <driver/pcnt.h>
 
 namespace {
-  uint32_t g_offAt = 0;   // millis deadline for auto-off
-  bool     g_on    = false;
+  constexpr int16_t TACH_LIM     = 30000;   // PCNT wraps to 0 here; at most one wrap per sample
+  constexpr float   RPM_PER_DUTY = (float)PUMP_RPM_FULL / Pump::ON_DUTY;   // clean pump, linear
+  static_assert(PUMP_RPM_WINDOW >= 1 && PUMP_RPM_WINDOW <= 8, "PUMP_RPM_WINDOW must be 1..8");
+
+  uint16_t loadPct(uint16_t rpm, uint8_t duty) {
+    return rpm ? (uint16_t)min<uint32_t>(duty * RPM_PER_DUTY * 100.0f / rpm, UINT16_MAX) : 0;
+  }
 }
 
+Pump::Pump(Hal::OutRef gate, uint8_t ledcCh, int8_t tachPin, uint8_t pcntUnit)
+  : gate_(gate), ch_(ledcCh), tachPin_(tachPin), unit_(pcntUnit), target_(PUMP_TARGET_RPM) {}
+
 void Pump::begin() {
-  ledcSetup(LEDC_CH, LEDC_HZ, LEDC_BITS);
-  ledcAttachPin(PIN, LEDC_CH);
-  setDuty(0);
-  g_on = false;
-  g_offAt = 0;
+  gate_.begin();   // gate driven low until the PWM output takes over
+  ledcSetup(ch_, LEDC_HZ, LEDC_BITS);
+  ledcAttachPin(gate_.pin, ch_);
+  drive(0);
+  if (hasTach()) tachBegin();
+}
+
+// FG rising edges on their own PCNT unit; read by regulate(), no ISR
+void Pump::tachBegin() {
+  const pcnt_unit_t u = (pcnt_unit_t)unit_;
+  pcnt_config_t c = {};
+  c.unit           = u;
+  c.channel        = PCNT_CHANNEL_0;
+  c.pulse_gpio_num = tachPin_;
+  c.ctrl_gpio_num  = PCNT_PIN_NOT_USED;
+  c.pos_mode       = PCNT_COUNT_INC;
+  c.neg_mode       = PCNT_COUNT_DIS;
+  c.lctrl_mode     = PCNT_MODE_KEEP;
+  c.hctrl_mode     = PCNT_MODE_KEEP;
+  c.counter_h_lim  = TACH_LIM;
+  c.counter_l_lim  = -1;
+  pcnt_unit_config(&c);
+  pcnt_set_filter_value(u, PUMP_TACH_FILTER);
+  pcnt_filter_enable(u);
+  pcnt_counter_pause(u);
+  pcnt_counter_clear(u);
+  pcnt_counter_resume(u);
+  LOGI("[Pump] ch%u tach on GPIO%d (PCNT unit %u), target %u rpm\n",
+       ch_, tachPin_, unit_, (unsigned)target_);
+}
+
+// The LEDC output stops in light sleep; keep APB up while it runs.
+// A latched trip holds the output at 0 whatever the caller asks for.
+void Pump::drive(uint8_t duty) {
+  if (trip_ != Trip::None) duty = 0;
+  ledcWrite(ch_, duty);
+  const bool on = duty > 0;
+  if (on && !on_) Power::acquire(Power::Lock::Pump);
+  if (!on && on_) Power::release(Power::Lock::Pump);
+  const bool changed = on != on_;
+  on_   = on;
+  duty_ = duty;
+  if (changed && runHook_) runHook_(on);
 }
 
 void Pump::setDuty(uint8_t duty) {
-  ledcWrite(LEDC_CH, duty);
-  g_on = duty > 0;
+  Timers::cancel(loopTimer_);
+  drive(duty);
+  rpm_ = 0;
+  setState(duty ? FlowState::OpenLoop : FlowState::Off);
 }
 
-void Pump::on()  { setDuty(ON_DUTY); }
-void Pump::off() { setDuty(0);       }
+// Manual on/off cancels a pending onFor() deadline
+void Pump::on() {
+  Timers::cancel(offTimer_);
+  if (trip_ != Trip::None) {
+    LOGW("[Pump] ch%u tripped (%s), not started; reset it first\n", ch_, name(trip_));
+    return;
+  }
+  if (on_) return;   // already running (speed loop or ramp)
+  startMs_ = Timers::nowMs();
+  if (!hasTach()) {
+    // Kick at full duty, then ramp down to the level
+    setDuty(ON_DUTY);
+    if (levelDuty_ != ON_DUTY) loopTimer_ = Timers::every(PUMP_RAMP_STEP_MS, ramp, this);
+    return;
+  }
+
+  // Spin up at full duty; the speed loop takes over from there
+  int16_t c = 0;
+  pcnt_get_counter_value((pcnt_unit_t)unit_, &c);
+  lastCount_ = c;
+  memset(win_, 0, sizeof(win_));
+  winIdx_  = winFill_ = 0;
+  winSum_  = 0;
+  dutyF_   = ON_DUTY;
+  pending_ = FlowState::SpinUp;
+  drive(ON_DUTY);
+  setState(FlowState::SpinUp);
+  loopTimer_ = Timers::every(PUMP_TACH_SAMPLE_MS, sample, this);
+}
+
+void Pump::off() {
+  Timers::cancel(offTimer_);
+  setDuty(0);
+}
 
 void Pump::onFor(uint32_t ms) {
   on();
-  g_offAt = millis() + ms;
+  offTimer_ = Timers::after(ms, [](void* self) {
+    Pump* p = static_cast<Pump*>(self);
+    p->offTimer_ = Timers::NONE;
+    p->off();
+  }, this);
+}
+
+// Monitor task: the LEDC write is immediate, the bookkeeping waits for poll()
+void Pump::trip(Trip why) {
+  if (why == Trip::None || trip_ != Trip::None) return;
+  trip_ = why;
+  ledcWrite(ch_, 0);
+  tripNew_ = true;
+  Sched::wake();
+}
+
+void Pump::poll() {
+  if (!tripNew_) return;
+  tripNew_ = false;
+  Timers::cancel(offTimer_);
+  setDuty(0);
+  LOGE("[Pump] ch%u tripped: %s, drive cut\n", ch_, name(trip_));
+}
+
+void Pump::resetTrip() {
+  if (trip_ == Trip::None) return;
+  poll();
+  LOGI("[Pump] ch%u trip (%s) reset\n", ch_, name(trip_));
+  trip_    = Trip::None;
+  tripNew_ = false;
+}
+
+void Pump::setTargetRpm(uint16_t rpm) { target_ = min<uint16_t>(rpm, PUMP_RPM_FULL); }
+
+void Pump::setLevel(uint8_t pct) {
+  level_ = min<uint8_t>(pct, 100);
+  if (hasTach()) {
+    setTargetRpm((uint32_t)PUMP_RPM_FULL * level_ / 100);
+    return;
+  }
+  levelDuty_ = (uint8_t)max<uint32_t>((uint32_t)ON_DUTY * level_ / 100, PUMP_DUTY_MIN);
+  if (on_ && duty_ != levelDuty_ && loopTimer_ == Timers::NONE) {
+    loopTimer_ = Timers::every(PUMP_RAMP_STEP_MS, ramp, this);
+  }
 }
 
-void Pump::update() {
-  if (g_offAt && millis() >= g_offAt) {
-    off();
-    g_offAt = 0;
+void Pump::ramp(void* self) { static_cast<Pump*>(self)->rampStep(); }
+
+// Open loop: PUMP_RAMP_COUNTS per step toward the level, stop when there
+void Pump::rampStep() {
+  if (Timers::nowMs() - startMs_ < PUMP_SPINUP_MS) return;
+  const int d = (int)levelDuty_ - duty_;
+  if (d == 0 || !on_) {
+    Timers::cancel(loopTimer_);
+    return;
   }
+  const int step = constrain(d, -PUMP_RAMP_COUNTS, PUMP_RAMP_COUNTS);
+  drive((uint8_t)(duty_ + step));
 }
 
-bool Pump::isOn() { return g_on; }
+void Pump::sample(void* self) { static_cast<Pump*>(self)->regulate(); }
+
+void Pump::regulate() {
+  const uint64_t now = Timers::nowMs();
+
+  // Pulses this sample -> moving sum over the window -> RPM
+  int16_t c = 0;
+  pcnt_get_counter_value((pcnt_unit_t)unit_, &c);
+  int32_t n = c - lastCount_;
+  if (n < 0) n += TACH_LIM;
+  lastCount_ = c;
+  winSum_ += n - win_[winIdx_];
+  win_[winIdx_] = (uint16_t)n;
+  winIdx_ = (winIdx_ + 1) % PUMP_RPM_WINDOW;
+  if (winFill_ < PUMP_RPM_WINDOW) winFill_++;
+  const uint32_t rpm = winSum_ * 60000UL / ((uint32_t)winFill_ * PUMP_TACH_SAMPLE_MS * PUMP_TACH_PPR);
+  rpm_ = (uint16_t)min<uint32_t>(rpm, UINT16_MAX);
+
+  const float err = (float)target_ - rpm_;
+  if (now - startMs_ < PUMP_SPINUP_MS) {
+    lastErr_ = err;
+    return;
+  }
+
+  // Incremental PI: bumpless from the spin-up duty, clamping is the anti-windup.
+  // No pulses drives it to full duty, i.e. open loop if only the tach is missing.
+  dutyF_ += PUMP_KP * (err - lastErr_) + PUMP_KI * err * (PUMP_TACH_SAMPLE_MS / 1000.0f);
+  dutyF_  = constrain(dutyF_, (float)PUMP_DUTY_MIN, (float)ON_DUTY);
+  lastErr_ = err;
+  drive((uint8_t)(dutyF_ + 0.5f));
+
+  // Flow health: what the pump needs for this speed vs a clean pump
+  const uint16_t load = loadPct(rpm_, duty_);
+  FlowState s = FlowState::Ok;
+  if (rpm_ == 0)                                          s = FlowState::NoPulses;
+  else if (duty_ == ON_DUTY
+           && rpm_ * 100UL < (uint32_t)target_ * (100 - PUMP_RPM_TOL_PCT)) s = FlowState::Saturated;
+  else if (load > PUMP_LOAD_HIGH_PCT)                     s = FlowState::Labored;
+  else if (load < PUMP_LOAD_LOW_PCT)                      s = FlowState::Light;
+  classify(s, now);
+}
+
+// A state is reported once it has held for PUMP_FAULT_MS; leaving spin-up is immediate
+void Pump::classify(FlowState s, uint64_t now) {
+  if (s != pending_) {
+    pending_   = s;
+    pendingMs_ = now;
+  }
+  if (s == FlowState::Ok && state_ == FlowState::SpinUp) setState(s);
+  else if (now - pendingMs_ >= PUMP_FAULT_MS)            setState(s);
+}
+
+void Pump::setState(FlowState s) {
+  if (s == state_) return;
+  const bool fault = s == FlowState::Labored || s == FlowState::Light
+                  || s == FlowState::Saturated || s == FlowState::NoPulses;
+  if (fault) {
+    LOGW("[Pump] ch%u flow %s: %u rpm at duty %u (load %u%%)\n",
+         ch_, name(s), (unsigned)rpm_, (unsigned)duty_, (unsigned)loadPct(rpm_, duty_));
+  } else if (state_ != FlowState::Off && state_ != FlowState::SpinUp && s == FlowState::Ok) {
+    LOGI("[Pump] ch%u flow ok again: %u rpm at duty %u\n", ch_, (unsigned)rpm_, (unsigned)duty_);
+  }
+  state_ = s;
+}
+
+Pump::Flow Pump::flow() const {
+  const uint16_t r = rpm_;
+  const uint8_t  d = duty_;
+  return { state_, r, target_, d, loadPct(r, d) };
+}
+
+const char* Pump::name(FlowState s) {
+  switch (s) {
+    case FlowState::Off:       return "off";
+    case FlowState::OpenLoop:  return "open loop";
+    case FlowState::SpinUp:    return "spin-up";
+    case FlowState::Ok:        return "ok";
+    case FlowState::Labored:   return "labored";
+    case FlowState::Light:     return "light (dry or blocked)";
+    case FlowState::Saturated: return "saturated";
+    case FlowState::NoPulses:  return "no tach pulses";
+  }
+  return "?";
+}
+
+const char* Pump::name(Trip t) {
+  switch (t) {
+    case Trip::None:    return "none";
+    case Trip::DryRun:  return "dry run";
+    case Trip::Stall:   return "stall";
+    case Trip::Clogged: return "clogged inlet";
+  }
+  return "?";
+}
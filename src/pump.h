@@ -1,19 +1,121 @@
 #pragma once
 #include <Arduino.h>
+#include "hal/out_pin.h"
+#include "timers.h"
 
-namespace Pump {
-  // Pas aan indien nodig
-  constexpr int  PIN      = 25;      // GPIO25 = Pump CTRL (jouw mapping)
-  constexpr int  LEDC_CH  = 0;       // vrij LEDC kanaal
-  constexpr int  LEDC_HZ  = 20000;   // ~20 kHz
-  constexpr int  LEDC_BITS= 8;       // 0..255 duty
-  constexpr uint8_t ON_DUTY = 255;   // volle kracht
+// PWM pomp-driver (LEDC), één instantie per tank
+//
+// With a tach (FG) input the pump is speed controlled: PCNT counts FG
+// pulses, the RPM is a moving sum over PUMP_RPM_WINDOW samples and a PI
+// loop on the timer wheel trims the LEDC duty to hold the target RPM while
+// the pump runs. The duty needed compared with a clean pump (PUMP_RPM_FULL)
+// is the flow health. Without a tach (pin -1) the pump runs open loop.
+//
+// setLevel() schedules how hard it runs: the target RPM with a tach, or
+// the open-loop duty, reached in small LEDC steps on the timer wheel
+// (PUMP_RAMP_*) after a full-duty kick at start.
+//
+// A protection trip (PumpCurrent: dry run, stall, clogged inlet) cuts the
+// drive from any task and latches until resetTrip(); poll() on the loop
+// task stops the timers and releases the power lock.
+class Pump {
+public:
+  static constexpr int  LEDC_HZ  = 20000;   // ~20 kHz
+  static constexpr int  LEDC_BITS= 8;       // 0..255 duty
+  static constexpr uint8_t ON_DUTY = 255;   // volle kracht
+
+  /** Flow health from RPM vs duty (centrifugal pump). */
+  enum class FlowState : uint8_t {
+    Off,        // stopped
+    OpenLoop,   // running without a tach
+    SpinUp,     // full duty before the speed loop takes over
+    Ok,
+    Labored,    // needs > PUMP_LOAD_HIGH_PCT duty: viscous etchant, worn or fouled impeller
+    Light,      // needs < PUMP_LOAD_LOW_PCT duty: running dry or outlet blocked
+    Saturated,  // full duty and still below the target RPM
+    NoPulses,   // no FG pulses: stalled pump or unwired tach (falls back to open loop)
+  };
+
+  /** Latched protection trip, raised by the current monitor. */
+  enum class Trip : uint8_t { None, DryRun, Stall, Clogged };
+
+  struct Flow {
+    FlowState state;
+    uint16_t  rpm;
+    uint16_t  targetRpm;
+    uint8_t   duty;
+    uint16_t  loadPct;   // duty needed vs a clean pump at this RPM (100 = nominal)
+  };
+
+  // gate: MOSFET-uitgang (HAL), ledcCh: vrij LEDC kanaal (niet 2/3: backlight-timer)
+  // tachPin: FG-ingang (-1 = geen), pcntUnit: vrije PCNT unit (niet 0: encoder)
+  Pump(Hal::OutRef gate, uint8_t ledcCh, int8_t tachPin = -1, uint8_t pcntUnit = 1);
 
   void begin();
-  void on();
+  void on();                      // speed loop with a tach, level duty (ramped) without
   void off();
-  void setDuty(uint8_t duty);     // 0..255
-  void onFor(uint32_t ms);        // zet aan en stop automatisch na ms
-  void update();                  // call in loop()
-  bool isOn();
-}
\ No newline at end of file
+  void setDuty(uint8_t duty);     // 0..255, open loop (stops the speed loop)
+  void onFor(uint32_t ms);        // zet aan en stop automatisch na ms (Timers)
+  bool isOn() const { return on_; }
+
+  /** Running level in % of full speed (tach: target RPM, else open-loop duty). */
+  void     setLevel(uint8_t pct);
+  uint8_t  level() const { return level_; }
+  void     setTargetRpm(uint16_t rpm);
+  uint16_t rpm() const { return rpm_; }
+  bool     hasTach() const { return tachPin_ >= 0; }
+  Flow     flow() const;
+
+  /** Cut the drive now (any task); latched, finished by poll() on the loop task. */
+  void trip(Trip why);
+  Trip tripped() const { return trip_; }
+  /** Clear a latched trip; the pump stays off until the next on(). */
+  void resetTrip();
+  /** Apply a pending trip (loop task). */
+  void poll();
+
+  /** Called with the new run state whenever the pump starts or stops (loop task). */
+  void onRunChange(void (*cb)(bool on)) { runHook_ = cb; }
+
+  static const char* name(FlowState s);
+  static const char* name(Trip t);
+
+private:
+  static void sample(void* self);
+  static void ramp(void* self);
+  void rampStep();
+  void drive(uint8_t duty);
+  void tachBegin();
+  void regulate();
+  void classify(FlowState s, uint64_t now);
+  void setState(FlowState s);
+
+  const Hal::OutRef gate_;
+  const uint8_t     ch_;
+  const int8_t      tachPin_;
+  const uint8_t     unit_;
+  Timers::Id        offTimer_ = Timers::NONE;   // pending auto-off of onFor()
+  Timers::Id        loopTimer_ = Timers::NONE;  // speed loop / open-loop ramp while running
+  uint8_t           level_     = 100;           // % of full speed
+  uint8_t           levelDuty_ = ON_DUTY;       // open-loop duty for level_
+  volatile bool     on_       = false;          // read by the control task
+  void            (*runHook_)(bool on) = nullptr;
+  volatile Trip     trip_     = Trip::None;     // written by the current monitor task
+  volatile bool     tripNew_  = false;          // trip not yet applied by poll()
+
+  // Speed loop (loop task)
+  uint16_t          target_;
+  int16_t           lastCount_ = 0;
+  uint16_t          win_[8]    = {};            // pulses per sample (PUMP_RPM_WINDOW <= 8)
+  uint8_t           winIdx_    = 0;
+  uint8_t           winFill_   = 0;
+  uint32_t          winSum_    = 0;
+  float             dutyF_     = 0.0f;
+  float             lastErr_   = 0.0f;
+  uint64_t          startMs_   = 0;
+  FlowState         pending_   = FlowState::Off; // candidate state, reported once held
+  uint64_t          pendingMs_ = 0;
+  volatile uint16_t rpm_       = 0;
+  volatile uint8_t  duty_      = 0;
+  volatile FlowState state_    = FlowState::Off;
+};
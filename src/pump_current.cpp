@@ -0,0 +1,188 @@
+// Pump supply current monitor: I2S ADC DMA -> per-window RMS / ripple -> trip
+#include "pump_current.h"
+#include "config.h"
+#include "seqlock.h"
+#include "timers.h"
+
+#include <driver/i2s.h>
+#include <driver/adc.h>
+#include <esp_adc_cal.h>
+
+namespace {
+  constexpr i2s_port_t PORT    = I2S_NUM_0;
+  constexpr size_t     SAMPLES = (size_t)PUMP_ISENSE_RATE_HZ * PUMP_ISENSE_WINDOW_MS / 1000;
+  constexpr uint32_t   TRIP_WINDOWS = (PUMP_ISENSE_TRIP_MS + PUMP_ISENSE_WINDOW_MS - 1) / PUMP_ISENSE_WINDOW_MS;
+  constexpr adc_atten_t ATTEN  = ADC_ATTEN_DB_11;   // ~0.15..2.45 V linear range
+  static_assert(SAMPLES >= 8 && SAMPLES <= 1024, "PUMP_ISENSE window must be 8..1024 samples (one DMA buffer)");
+
+  Pump*                    pump  = nullptr;
+  TaskHandle_t             task  = nullptr;
+  esp_adc_cal_characteristics_t cal{};
+  uint16_t                 buf[SAMPLES];           // monitor task only
+  SeqLock<PumpCurrent::Reading> lastReading;
+  PumpCurrent::Stats       st{};
+  portMUX_TYPE             mux = portMUX_INITIALIZER_UNLOCKED;
+
+  uint16_t toMa(uint32_t raw) {
+    const uint32_t mV = esp_adc_cal_raw_to_voltage(min<uint32_t>(raw, 4095), &cal);
+    return (uint16_t)min<uint32_t>(mV * 1000UL / PUMP_ISENSE_MV_PER_A, UINT16_MAX);
+  }
+
+  // Clean pump at this speed: the tach when there is one, otherwise the duty
+  uint16_t expectedMa() {
+    float f = pump->hasTach() && pump->rpm() ? (float)pump->rpm() / PUMP_RPM_FULL
+                                             : (float)pump->flow().duty / Pump::ON_DUTY;
+    f = min(f, 1.2f);
+    return (uint16_t)(PUMP_ISENSE_IDLE_MA + (PUMP_ISENSE_NOMINAL_MA - PUMP_ISENSE_IDLE_MA) * f * f * f);
+  }
+
+  Pump::Trip judge(const PumpCurrent::Reading& r) {
+    if (r.meanMa >= PUMP_ISENSE_STALL_MA || r.meanMa <= PUMP_ISENSE_OPEN_MA) return Pump::Trip::Stall;
+    const bool rough = r.ripplePct >= PUMP_ISENSE_RIPPLE_PCT;
+    if (r.loadPct < PUMP_ISENSE_DRY_PCT && !rough) return Pump::Trip::DryRun;
+    if (r.loadPct < PUMP_ISENSE_CLOG_PCT && rough) return Pump::Trip::Clogged;
+    return Pump::Trip::None;
+  }
+
+  // One DMA buffer: 12-bit ADC1 codes in the low bits (channel in the top nibble)
+  PumpCurrent::Reading analyse(size_t n) {
+    uint32_t sum = 0;
+    uint64_t sq  = 0;
+    for (size_t i = 0; i < n; ++i) {
+      const uint32_t v = buf[i] & 0x0FFF;
+      sum += v;
+      sq  += v * v;
+    }
+    const float mean = (float)sum / n;
+    const float rms  = sqrtf((float)sq / n);
+    const float ac   = sqrtf(max(0.0f, rms * rms - mean * mean));
+
+    PumpCurrent::Reading r{};
+    r.meanMa = toMa((uint32_t)(mean + 0.5f));
+    r.rmsMa  = toMa((uint32_t)(rms + 0.5f));
+    const uint16_t acMa = toMa((uint32_t)(mean + ac + 0.5f)) - r.meanMa;
+    r.ripplePct = r.meanMa ? (uint8_t)min<uint32_t>(acMa * 100UL / r.meanMa, 255) : 0;
+    r.loadPct   = (uint16_t)min<uint32_t>(r.meanMa * 100UL / expectedMa(), UINT16_MAX);
+    r.verdict   = judge(r);
+    return r;
+  }
+
+  // Blocks in i2s_read() while the pump runs, on the task notification while it is off
+  void run(void*) {
+    bool     sampling = false;
+    uint64_t startMs  = 0;
+    uint32_t streak   = 0;
+    for (;;) {
+      if (!pump->isOn()) {
+        if (sampling) {
+          i2s_adc_disable(PORT);
+          i2s_stop(PORT);
+        }
+        sampling = false;
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        continue;
+      }
+      if (!sampling) {
+        i2s_adc_enable(PORT);
+        i2s_start(PORT);
+        sampling = true;
+        startMs  = Timers::nowMs();
+        streak   = 0;
+      }
+
+      size_t got = 0;
+      i2s_read(PORT, buf, sizeof(buf), &got, pdMS_TO_TICKS(4 * PUMP_ISENSE_WINDOW_MS));
+      if (got < sizeof(buf)) {
+        portENTER_CRITICAL(&mux);
+        st.shortReads++;
+        portEXIT_CRITICAL(&mux);
+        continue;
+      }
+      // Stale buffers from the last run and the inrush fall in the blanking time
+      if (Timers::nowMs() - startMs < PUMP_ISENSE_BLANK_MS) continue;
+      if (!pump->isOn() || pump->tripped() != Pump::Trip::None) continue;
+
+      const PumpCurrent::Reading r = analyse(SAMPLES);
+      lastReading.write(r);
+      streak = r.verdict == Pump::Trip::None ? 0 : streak + 1;
+      const bool trip = streak >= TRIP_WINDOWS;
+
+      portENTER_CRITICAL(&mux);
+      st.windows++;
+      if (r.meanMa > st.peakMa) st.peakMa = r.meanMa;
+      if (trip) st.trips++;
+      portEXIT_CRITICAL(&mux);
+
+      if (trip) {
+        pump->trip(r.verdict);
+        LOGE("[ISense] %s: %u mA (rms %u, ripple %u%%, load %u%%)\n", Pump::name(r.verdict),
+             (unsigned)r.meanMa, (unsigned)r.rmsMa, (unsigned)r.ripplePct, (unsigned)r.loadPct);
+        streak = 0;
+      }
+    }
+  }
+
+  // Pump start / stop (loop task)
+  void onRun(bool on) {
+    if (on && task) xTaskNotifyGive(task);
+  }
+}
+
+namespace PumpCurrent {
+
+void begin(Pump& p) {
+  if (PIN_PUMP_ISENSE < 0) return;
+  const int ch = digitalPinToAnalogChannel(PIN_PUMP_ISENSE);
+  if (ch < 0 || ch >= ADC1_CHANNEL_MAX) {
+    LOGE("[ISense] GPIO%d is not an ADC1 pin, monitor off\n", PIN_PUMP_ISENSE);
+    return;
+  }
+
+  i2s_config_t c = {};
+  c.mode                 = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_RX | I2S_MODE_ADC_BUILT_IN);
+  c.sample_rate          = PUMP_ISENSE_RATE_HZ;
+  c.bits_per_sample      = I2S_BITS_PER_SAMPLE_16BIT;
+  c.channel_format       = I2S_CHANNEL_FMT_ONLY_LEFT;
+  c.communication_format = I2S_COMM_FORMAT_STAND_I2S;
+  c.intr_alloc_flags     = ESP_INTR_FLAG_LEVEL1;
+  c.dma_buf_count        = 4;
+  c.dma_buf_len          = SAMPLES;
+  if (i2s_driver_install(PORT, &c, 0, nullptr) != ESP_OK) {
+    LOGE("[ISense] I2S ADC install failed, monitor off\n");
+    return;
+  }
+  adc1_config_width(ADC_WIDTH_BIT_12);
+  adc1_config_channel_atten((adc1_channel_t)ch, ATTEN);
+  i2s_set_adc_mode(ADC_UNIT_1, (adc1_channel_t)ch);
+  i2s_stop(PORT);   // no DMA traffic until the pump runs
+  esp_adc_cal_characterize(ADC_UNIT_1, ATTEN, ADC_WIDTH_BIT_12, 1100, &cal);
+
+  pump = &p;
+  xTaskCreatePinnedToCore(run, "isense", PUMP_ISENSE_TASK_STACK, nullptr,
+                          PUMP_ISENSE_TASK_PRIO, &task, PUMP_ISENSE_TASK_CORE);
+  p.onRunChange(onRun);
+  LOGI("[ISense] GPIO%d (ADC1 ch%d), %d Hz, %u-sample windows, trip after %u ms\n",
+       PIN_PUMP_ISENSE, ch, PUMP_ISENSE_RATE_HZ, (unsigned)SAMPLES, (unsigned)(TRIP_WINDOWS * PUMP_ISENSE_WINDOW_MS));
+}
+
+bool enabled() { return pump != nullptr; }
+
+Reading last() { return lastReading.read(); }
+
+Stats stats() {
+  portENTER_CRITICAL(&mux);
+  const Stats s = st;
+  portEXIT_CRITICAL(&mux);
+  return s;
+}
+
+void report() {
+  if (!enabled()) return;
+  const Reading r = last();
+  const Stats   s = stats();
+  LOGI("[ISense] %u mA (rms %u, ripple %u%%, load %u%%), peak %u mA, windows %lu, short %lu, trips %lu\n",
+       (unsigned)r.meanMa, (unsigned)r.rmsMa, (unsigned)r.ripplePct, (unsigned)r.loadPct,
+       (unsigned)s.peakMa, (unsigned long)s.windows, (unsigned long)s.shortReads, (unsigned long)s.trips);
+}
+
+} // namespace PumpCurrent
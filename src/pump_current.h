@@ -0,0 +1,48 @@
+#pragma once
+#include <Arduino.h>
+#include "pump.h"
+
+/*
+  Pump supply current monitor (PIN_PUMP_ISENSE)
+  - The I2S peripheral drives ADC1 in DMA mode at PUMP_ISENSE_RATE_HZ; a
+    low-priority task blocks in i2s_read() until a buffer is full, so the
+    CPU only sees one wake-up per PUMP_ISENSE_WINDOW_MS, never a sample
+  - Per window: mean, RMS and ripple (AC RMS vs mean) of the current, and
+    the load vs a clean pump at the same speed (affinity law: the shaft
+    power of a centrifugal pump goes with speed cubed)
+  - Dry run (light and smooth), stall (locked rotor, or no current while
+    driven) and a clogged inlet (light with cavitation ripple) held for
+    PUMP_ISENSE_TRIP_MS trip the pump: Pump::trip() cuts the drive at once
+  - Sampling runs only while the pump runs; the Pump power lock keeps the
+    clocks up (no light sleep) for that time
+  One I2S ADC, so one monitored pump per station (PUMP_ISENSE_TANK).
+*/
+namespace PumpCurrent {
+
+/** Latest analysis window. */
+struct Reading {
+  uint16_t   meanMa;
+  uint16_t   rmsMa;
+  uint8_t    ripplePct;   // AC RMS vs mean
+  uint16_t   loadPct;     // mean vs a clean pump at this speed (100 = nominal)
+  Pump::Trip verdict;     // this window alone, before PUMP_ISENSE_TRIP_MS
+};
+
+struct Stats {
+  uint32_t windows;       // windows analysed
+  uint32_t shortReads;    // i2s_read() timeouts / partial buffers
+  uint16_t peakMa;        // highest window mean after blanking
+  uint32_t trips;
+};
+
+/** Start the I2S ADC and the monitor task for `pump` (no-op without PIN_PUMP_ISENSE). */
+void begin(Pump& pump);
+
+bool    enabled();
+Reading last();
+Stats   stats();
+
+/** Log the last window and the counters. */
+void report();
+
+} // namespace PumpCurrent
@@ -0,0 +1,49 @@
+// Main-loop deadline scheduler (task notifications, no busy polling)
+#include "scheduler.h"
+#include "config.h"
+
+namespace {
+  TaskHandle_t loopTask = nullptr;
+  Sched::Stats st{};
+  uint32_t     lastWakeMs = 0;
+}
+
+namespace Sched {
+
+void begin() {
+  loopTask   = xTaskGetCurrentTaskHandle();
+  lastWakeMs = millis();
+}
+
+bool inLoop() { return xTaskGetCurrentTaskHandle() == loopTask; }
+
+void wake() {
+  if (loopTask) xTaskNotifyGive(loopTask);
+}
+
+void IRAM_ATTR wakeFromISR() {
+  if (!loopTask) return;
+  BaseType_t woken = pdFALSE;
+  vTaskNotifyGiveFromISR(loopTask, &woken);
+  if (woken) portYIELD_FROM_ISR();
+}
+
+bool idle(uint32_t ms) {
+  const uint32_t t0 = millis();
+  st.busyMs += t0 - lastWakeMs;
+  bool early = false;
+  if (ms) {
+    TickType_t ticks = (ms == NEVER) ? portMAX_DELAY : pdMS_TO_TICKS(ms);
+    if (ticks == 0) ticks = 1;
+    early = ulTaskNotifyTake(pdTRUE, ticks) > 0;
+  }
+  lastWakeMs = millis();
+  st.idleMs += lastWakeMs - t0;
+  st.passes++;
+  if (early) st.earlyWakes++;
+  return early;
+}
+
+Stats stats() { return st; }
+
+} // namespace Sched
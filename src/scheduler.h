@@ -0,0 +1,43 @@
+#pragma once
+#include <Arduino.h>
+
+/*
+  Deadline scheduler for the main loop.
+  loop() does one pass over all modules and then blocks the loop task until
+  the next timer-wheel deadline (Timers::msUntilNext()), or until an input
+  source wakes it. With
+  nothing due the CPU sits in the FreeRTOS idle task instead of spinning.
+*/
+namespace Sched {
+
+/** "Nothing scheduled" for idle() / msUntilNext() style delays. */
+constexpr uint32_t NEVER = UINT32_MAX;
+
+struct Stats {
+  uint32_t passes;      // loop passes (wake-ups)
+  uint32_t earlyWakes;  // passes started by wake()/wakeFromISR() before the deadline
+  uint64_t idleMs;      // total time blocked in idle()
+  uint64_t busyMs;      // total time spent between idle() calls
+};
+
+/** Bind to the calling task (call from setup(), which runs on the loop task). */
+void begin();
+
+/** True when called from the loop task. */
+bool inLoop();
+
+/** Wake the loop early from task context (e.g. a timer callback). */
+void wake();
+
+/** Wake the loop early from an ISR. */
+void wakeFromISR();
+
+/**
+ * Block the loop task for up to `ms` (NEVER = until woken).
+ * Returns true if woken before the timeout.
+ */
+bool idle(uint32_t ms);
+
+Stats stats();
+
+} // namespace Sched
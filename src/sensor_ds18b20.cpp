@@ -1,71 +1,180 @@
 #include "sensor_ds18b20.h"
-#include "config.h"
-
-#include <OneWire.h>
-#include <DallasTemperature.h>
+#include "timers.h"
+#include "power.h"
 
 namespace {
-  OneWire           ow(TS_PIN);
-  DallasTemperature dt(&ow);
-  DeviceAddress     rom{};
-  bool              hasDevice = false;
+  // DS18B20 scratchpad layout
+  constexpr uint8_t SP_TH  = 2;
+  constexpr uint8_t SP_TL  = 3;
+  constexpr uint8_t SP_CFG = 4;
+  constexpr uint8_t SP_CRC = 8;
+  constexpr uint8_t CMD_WRITE_SCRATCH = 0x4E;
+  // Configuration register value for a given resolution (9..12 bit)
+  constexpr uint8_t cfgFor(uint8_t bits) { return (uint8_t)(((bits - 9) << 5) | 0x1F); }
+  // Attach marker in the (unused) alarm registers; RAM only, so a power-on
+  // reset brings back the EEPROM values (factory 0x4B/0x46) and clears it
+  constexpr uint8_t MARK_TH = 0x50;   // 'P'
+  constexpr uint8_t MARK_TL = 0x45;   // 'E'
+}
 
-  uint32_t  lastKickMs = 0;
-  bool      waiting    = false;
-  float     lastC      = NAN;
+TempProbe::TempProbe(uint8_t pin)
+  : pin_(pin), ow_(pin), dt_(&ow_),
+    convMs_(DallasTemperature::millisToWaitForConversion(TS_RES)) {}
 
-  void kickConversion() {
-    if (!hasDevice) return;
-    dt.requestTemperaturesByAddress(rom);
-    waiting   = true;
-    lastKickMs= millis();
+void TempProbe::kickConversion() {
+  if (!hasDevice_) return;
+  Power::Hold bus(Power::Lock::OneWire);
+  if (!dt_.requestTemperaturesByAddress(rom_)) {
+    // Probe did not answer; let service() count it against the fail budget
+    st_.noPresence++;
+    fails_++;
   }
+  waiting_    = true;
+  lastKickMs_ = Timers::nowMs();
 }
 
-namespace TempSensor {
+// Enumerate the bus and attach to the first probe found.
+bool TempProbe::scan() {
+  lastScanMs_ = Timers::nowMs();
+  Power::Hold bus(Power::Lock::OneWire);
+  dt_.begin();                      // reset_search + full enumeration
+  if (!dt_.getAddress(rom_, 0)) {
+    backoffMs_ = min<uint32_t>(backoffMs_ * 2, TS_RESCAN_MAX_MS);
+    return false;
+  }
+  hasDevice_ = true;
+  fails_     = 0;
+  backoffMs_ = TS_RESCAN_MIN_MS;
+  st_.attaches++;
+  writeConfig();
+  LOGI("[Temp] DS18B20 %02X%02X%02X%02X%02X%02X%02X%02X attached on pin %d, res=%d-bit\n",
+       rom_[0], rom_[1], rom_[2], rom_[3], rom_[4], rom_[5], rom_[6], rom_[7], pin_, TS_RES);
+  kickConversion();
+  return true;
+}
 
-void begin() {
-  dt.begin();
-  dt.setWaitForConversion(false); // non-blocking
-  if (dt.getAddress(rom, 0)) {
-    hasDevice = true;
-    dt.setResolution(rom, TS_RES);
-    LOGI("[Temp] DS18B20 found, res=%d-bit\n", TS_RES);
-    kickConversion();
-  } else {
-    hasDevice = false;
-    LOGW("[Temp] No DS18B20 found on pin %d\n", TS_PIN);
+// Resolution + attach marker into the scratchpad only. DallasTemperature's
+// setResolution() also copies to EEPROM, which would make the marker
+// survive a power-on reset (and wears the EEPROM on every re-attach).
+void TempProbe::writeConfig() {
+  if (!ow_.reset()) return;   // next read shows the missing marker and retries
+  ow_.select(rom_);
+  ow_.write(CMD_WRITE_SCRATCH);
+  ow_.write(MARK_TH);
+  ow_.write(MARK_TL);
+  ow_.write(cfgFor(TS_RES));
+  ow_.reset();
+}
+
+void TempProbe::detach(const char* why) {
+  LOGW("[Temp] Probe on pin %d lost (%s), re-scanning bus\n", pin_, why);
+  hasDevice_  = false;
+  waiting_    = false;
+  lastRaw_    = Temp::NONE;
+  backoffMs_  = TS_RESCAN_MIN_MS;
+  lastScanMs_ = Timers::nowMs() - backoffMs_;   // first re-scan right away
+}
+
+// Read + validate the scratchpad, retrying up to TS_READ_RETRIES times.
+bool TempProbe::readScratch(uint8_t* sp) {
+  for (uint8_t i = 0; i < TS_READ_RETRIES; ++i) {
+    if (!dt_.readScratchPad(rom_, sp)) { st_.noPresence++; continue; }
+    bool zeros = true;
+    for (uint8_t k = 0; k < 9; ++k) if (sp[k]) { zeros = false; break; }
+    if (!zeros && OneWire::crc8(sp, 8) == sp[SP_CRC]) return true;
+    st_.crcErrors++;
   }
+  return false;
 }
 
-void update() {
-  const uint32_t now = millis();
-  if (!hasDevice) return;
+// Conversion finished: fetch, validate and publish the reading.
+void TempProbe::collect() {
+  Power::Hold bus(Power::Lock::OneWire);
+  uint8_t sp[9];
+  if (!readScratch(sp)) {
+    st_.dropped++;
+    lastRaw_ = Temp::NONE;
+    fails_++;
+    return;
+  }
+  fails_ = 0;
+  if (sp[SP_TH] != MARK_TH || sp[SP_TL] != MARK_TL || sp[SP_CFG] != cfgFor(TS_RES)) {
+    // Probe went through a power-on reset (re-plugged, swapped, a knock on
+    // the connector mid-conversion): the marker is gone and the value is
+    // the 85 °C power-on value, CRC-valid at any resolution.
+    LOGW("[Temp] Probe reset detected, re-applying %d-bit\n", TS_RES);
+    writeConfig();
+    return;
+  }
+  // Kept in the scratchpad's 1/16 °C: no float on the way to the controller
+  Temp::Raw raw = (Temp::Raw)((sp[1] << 8) | sp[0]);
+  raw &= ~((1 << (12 - TS_RES)) - 1);  // undefined LSBs below 12-bit
+  lastRaw_ = (raw > -55 * Temp::ONE_C && raw < 125 * Temp::ONE_C) ? raw : Temp::NONE;
+}
 
-  // If waiting, check if conversion completed or timed out
-  if (waiting) {
-    if (dt.isConversionComplete()) {
-      float t = dt.getTempC(rom);
-      if (t != DEVICE_DISCONNECTED_C && t > -55.0f && t < 125.0f) {
-        lastC = t;
-      } else {
-        lastC = NAN;
-      }
-      waiting = false;
+// One state-machine step: scan, kick, poll or collect
+void TempProbe::service() {
+  const uint64_t now = Timers::nowMs();
+  if (!hasDevice_) {
+    if (now - lastScanMs_ >= backoffMs_) {
+      st_.rescans++;
+      scan();
+    }
+    return;
+  }
+
+  if (fails_ >= TS_MAX_FAILS) {
+    detach("no valid reads");
+    return;
+  }
+
+  // If waiting, check if conversion completed or timed out. The bus is
+  // only polled once the nominal conversion time has passed.
+  if (waiting_) {
+    if (now - lastKickMs_ < convMs_) return;
+    bool done;
+    {
+      Power::Hold bus(Power::Lock::OneWire);
+      done = dt_.isConversionComplete();
+    }
+    if (done) {
+      collect();
+      waiting_ = false;
       // schedule next kick after period
-      if (now - lastKickMs >= TS_DEFAULT_PERIOD_MS) kickConversion();
-    } else if (now - lastKickMs > TS_TIMEOUT_MS) {
+      if (now - lastKickMs_ >= TS_DEFAULT_PERIOD_MS) kickConversion();
+    } else if (now - lastKickMs_ > TS_TIMEOUT_MS) {
       LOGW("[Temp] Conversion timeout\n");
-      waiting = false;
+      st_.timeouts++;
+      fails_++;
+      waiting_ = false;
       // Try again next cycle
     }
   } else {
     // Not waiting: time to start next conversion?
-    if (now - lastKickMs >= TS_DEFAULT_PERIOD_MS) kickConversion();
+    if (now - lastKickMs_ >= TS_DEFAULT_PERIOD_MS) kickConversion();
   }
 }
 
-float latestC()   { return lastC; }
-bool  healthy()   { return !isnan(lastC); }
+// Delay until service() next has work to do
+uint32_t TempProbe::dueIn() const {
+  const uint64_t now = Timers::nowMs();
+  if (!hasDevice_)            return Timers::remaining(lastScanMs_, backoffMs_, now);
+  if (fails_ >= TS_MAX_FAILS) return 0;
+  if (!waiting_)              return Timers::remaining(lastKickMs_, TS_DEFAULT_PERIOD_MS, now);
+  const uint32_t conv = Timers::remaining(lastKickMs_, convMs_, now);
+  return conv ? conv : TS_POLL_MS;
+}
+
+void TempProbe::step(void* self) {
+  TempProbe* p = static_cast<TempProbe*>(self);
+  p->service();
+  Timers::after(p->dueIn(), step, p);
+}
 
-} // namespace TempSensor
\ No newline at end of file
+void TempProbe::begin() {
+  dt_.setWaitForConversion(false); // non-blocking
+  if (!scan()) {
+    LOGW("[Temp] No DS18B20 found on pin %d, re-scanning in background\n", pin_);
+  }
+  Timers::after(dueIn(), step, this);   // self-rescheduling from here on
+}
@@ -1,18 +1,83 @@
 #pragma once
 #include <Arduino.h>
+#include <OneWire.h>
+#include <DallasTemperature.h>
+#include "config.h"
+#include "temp_fixed.h"
 
-namespace TempSensor {
+/**
+ * One DS18B20 probe on its own 1-Wire pin (one instance per tank).
+ *
+ * begin() initialises OneWire + DallasTemperature in non-blocking mode and
+ * starts the bus state machine on the timer wheel (runs from Timers::run()).
+ * Conversions are triggered every TS_DEFAULT_PERIOD_MS and the bus is only
+ * polled once the nominal conversion time has passed.
+ * Without a probe the bus is re-scanned with exponential backoff
+ * (TS_RESCAN_MIN_MS..TS_RESCAN_MAX_MS); a probe that stops answering for
+ * TS_MAX_FAILS conversions is dropped and searched for again, so hot-plugged
+ * or swapped probes resume conversions without a reboot.
+ */
+class TempProbe {
+public:
+  /** Bus health counters (monotonic since boot). */
+  struct Stats {
+    uint32_t crcErrors;   // scratchpad reads with a bad CRC or all-zero payload
+    uint32_t noPresence;  // reads where no device answered the reset pulse
+    uint32_t timeouts;    // conversions that did not complete within TS_TIMEOUT_MS
+    uint32_t dropped;     // conversions discarded after TS_READ_RETRIES failed reads
+    uint32_t rescans;     // bus enumerations attempted while no probe was attached
+    uint32_t attaches;    // probes (re)attached, including the one found at boot
+  };
 
-/** Initialise OneWire + DallasTemperature, non-blocking mode. */
-void begin();
+  explicit TempProbe(uint8_t pin);
+  TempProbe(const TempProbe&) = delete;
+  TempProbe& operator=(const TempProbe&) = delete;
 
-/** Call periodically (e.g. every loop). Triggers conversions at TS_DEFAULT_PERIOD_MS. */
-void update();
+  /** Enumerate the bus and start the background state machine. */
+  void begin();
 
-/** Latest temperature in °C, or NAN if not available yet. */
-float latestC();
+  /** Latest reading straight from the scratchpad (1/16 °C), Temp::NONE if not available. */
+  Temp::Raw latestRaw() const { return lastRaw_; }
 
-/** True if we have seen at least one valid reading. */
-bool healthy();
+  /** Latest temperature in °C, or NAN if not available yet. */
+  float latestC() const { return Temp::toC(lastRaw_); }
 
-} // namespace TempSensor
\ No newline at end of file
+  /** True if we have seen at least one valid reading. */
+  bool healthy() const { return lastRaw_ != Temp::NONE; }
+
+  /** True while a probe is attached (enumerated and answering). */
+  bool present() const { return hasDevice_; }
+
+  /** Snapshot of the bus error counters. */
+  Stats stats() const { return st_; }
+
+  uint8_t pin() const { return pin_; }
+
+private:
+  static void step(void* self);
+  void     service();
+  uint32_t dueIn() const;
+  void     kickConversion();
+  bool     scan();
+  void     writeConfig();
+  void     detach(const char* why);
+  bool     readScratch(uint8_t* sp);
+  void     collect();
+
+  const uint8_t     pin_;
+  OneWire           ow_;
+  DallasTemperature dt_;
+  DeviceAddress     rom_{};
+  bool              hasDevice_  = false;
+
+  uint64_t          lastKickMs_ = 0;
+  const uint32_t    convMs_;
+  bool              waiting_    = false;
+  volatile Temp::Raw lastRaw_   = Temp::NONE;   // read by the control task (one 16-bit access)
+
+  // Hot-plug bookkeeping
+  uint8_t           fails_      = 0;      // consecutive failed conversions
+  uint64_t          lastScanMs_ = 0;
+  uint32_t          backoffMs_  = TS_RESCAN_MIN_MS;
+  Stats             st_{};
+};
@@ -0,0 +1,51 @@
+#pragma once
+#include <atomic>
+#include <string.h>
+#include <stdint.h>
+#include <type_traits>
+
+/**
+ * Single-writer sequence lock around a trivially copyable value.
+ * write() never blocks or retries; readers copy the value and retry only if
+ * a write overlapped the copy (odd or changed sequence number). No mutex,
+ * so the writer's timing does not depend on how many readers there are.
+ * A reader must not preempt the writer on the writer's core (it would spin
+ * on an odd sequence); give the writer the higher priority.
+ */
+template <typename T>
+class SeqLock {
+  static_assert(std::is_trivially_copyable<T>::value, "SeqLock needs a trivially copyable T");
+
+public:
+  /** Publish a new value (single writer). */
+  void write(const T& v) {
+    const uint32_t s = seq_.load(std::memory_order_relaxed);
+    seq_.store(s + 1, std::memory_order_relaxed);          // odd: write in progress
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(&data_, &v, sizeof(T));
+    seq_.store(s + 2, std::memory_order_release);
+  }
+
+  /** One copy attempt; false if it overlapped a write. */
+  bool tryRead(T& out) const {
+    const uint32_t s1 = seq_.load(std::memory_order_acquire);
+    if (s1 & 1) return false;
+    memcpy(&out, &data_, sizeof(T));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return seq_.load(std::memory_order_relaxed) == s1;
+  }
+
+  /** Consistent copy of the last published value. */
+  T read() const {
+    T out;
+    while (!tryRead(out)) {}
+    return out;
+  }
+
+  /** Number of completed writes. */
+  uint32_t version() const { return seq_.load(std::memory_order_acquire) >> 1; }
+
+private:
+  std::atomic<uint32_t> seq_{0};
+  T data_{};
+};
@@ -0,0 +1,43 @@
+#pragma once
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Fixed-size single-producer / single-consumer ring buffer.
+ * Lock-free: push() and pop() may run concurrently from different tasks
+ * (or an ISR and a task) without a mutex, as long as there is exactly one
+ * producer and one consumer. N must be a power of two.
+ */
+template <typename T, size_t N>
+class SpscQueue {
+  static_assert(N && (N & (N - 1)) == 0, "SpscQueue size must be a power of two");
+
+public:
+  /** Append an element; returns false (element dropped) when full. */
+  bool push(const T& v) {
+    const uint32_t h = head_.load(std::memory_order_relaxed);
+    if (h - tail_.load(std::memory_order_acquire) == N) return false;
+    buf_[h & (N - 1)] = v;
+    head_.store(h + 1, std::memory_order_release);
+    return true;
+  }
+
+  /** Remove the oldest element into v; returns false when empty. */
+  bool pop(T& v) {
+    const uint32_t t = tail_.load(std::memory_order_relaxed);
+    if (t == head_.load(std::memory_order_acquire)) return false;
+    v = buf_[t & (N - 1)];
+    tail_.store(t + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool empty() const {
+    return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+  }
+
+private:
+  T buf_[N];
+  std::atomic<uint32_t> head_{0};
+  std::atomic<uint32_t> tail_{0};
+};
@@ -0,0 +1,114 @@
+// Warm standby and scheduled preheat: planners on the loop task (see standby.h)
+#include "standby.h"
+#include "config.h"
+#include "tanks.h"
+#include "system_state.h"
+#include "timers.h"
+
+#include <atomic>
+#include <time.h>
+
+namespace {
+  constexpr StandbyPlanner::Policy POLICY = {
+    STANDBY_C, STANDBY_IDLE_MS, STANDBY_MARGIN_MS,
+    STANDBY_RATE_INIT_C_PER_MIN, STANDBY_LEARN_ALPHA, STANDBY_LEARN_MIN_C
+  };
+  constexpr StandbyPlanner::Shift SHIFT = { STANDBY_SHIFT_DAYS, STANDBY_SHIFT_START_MIN };
+  constexpr time_t CLOCK_VALID = 1700000000;   // earlier = SNTP has not set the clock yet
+
+  struct Slot {
+    StandbyPlanner        plan{POLICY, SHIFT};
+    std::atomic<float>    overrideC{NAN};      // loop task -> control task
+    StandbyPlanner::Mode  shown = StandbyPlanner::Mode::Ready;
+  };
+  Slot slots[TANK_COUNT];
+
+  // Minutes since Sunday 00:00 local time
+  int32_t wallMin() {
+    const time_t t = time(nullptr);
+    if (t < CLOCK_VALID) return StandbyPlanner::NO_WALL_CLOCK;
+    struct tm lt;
+    localtime_r(&t, &lt);
+    return lt.tm_wday * 24 * 60 + lt.tm_hour * 60 + lt.tm_min;
+  }
+
+  void poll(void*) {
+    const uint64_t now = Timers::nowMs();
+    const int32_t  wm  = wallMin();
+    for (uint8_t i = 0; i < Tanks::COUNT; ++i) {
+      Tank& t = Tanks::at(i);
+      Slot& s = slots[i];
+      const SystemState st = SharedState::read(i);
+      const bool busy = t.profile.running() || t.circ.mode() == Circulation::Mode::Manual;
+      // A disabled heater is not a warm-up: hide the bath so none is learned
+      const float bathC = t.heater.enabled() ? Temp::toC(st.tempRaw) : NAN;
+      s.plan.update(now, wm, bathC, t.heater.getSetpointC(), busy);
+      s.overrideC.store(s.plan.overrideC());
+
+      const StandbyPlanner::Mode m = s.plan.mode();
+      if (m == s.shown) continue;
+      s.shown = m;
+      if (m == StandbyPlanner::Mode::Standby) {
+        LOGI("[Standby] %s: holding %.1f C\n", t.name, s.plan.overrideC());
+      } else if (m == StandbyPlanner::Mode::Preheat) {
+        LOGI("[Standby] %s: preheat from %.1f C at %.2f C/min, ready in %lu min\n", t.name, Temp::toC(st.tempRaw),
+             s.plan.rateCPerMin(), (unsigned long)(s.plan.msToReady(now, wm) / 60000));
+      } else {
+        LOGI("[Standby] %s: ready (arrived %+.1f C)\n", t.name, s.plan.stats().lastArrivalC);
+      }
+    }
+  }
+}
+
+namespace Standby {
+
+void begin() {
+  if (!STANDBY_IDLE_MS) {
+    LOGI("[Standby] Disabled (STANDBY_IDLE_MS=0)\n");
+    return;
+  }
+#if FLEET_ENABLE
+  if (STANDBY_SHIFT_DAYS) configTzTime(STANDBY_TZ, STANDBY_NTP);
+#else
+  if (STANDBY_SHIFT_DAYS) LOGW("[Standby] Shift calendar needs the clock from SNTP (FLEET_ENABLE)\n");
+#endif
+  activity();
+  Timers::every(STANDBY_POLL_MS, poll);
+  LOGI("[Standby] %.1f C after %lu min idle, shifts 0x%02x at %02d:%02d\n", STANDBY_C,
+       (unsigned long)(STANDBY_IDLE_MS / 60000), STANDBY_SHIFT_DAYS,
+       STANDBY_SHIFT_START_MIN / 60, STANDBY_SHIFT_START_MIN % 60);
+}
+
+void activity() {
+  const uint64_t now = Timers::nowMs();
+  for (uint8_t i = 0; i < Tanks::COUNT; ++i) {
+    slots[i].plan.activity(now);
+    slots[i].overrideC.store(NAN);   // don't wait for the next poll
+  }
+}
+
+float setpointC(uint8_t tank) { return tank < TANK_COUNT ? slots[tank].overrideC.load() : NAN; }
+
+StandbyPlanner::Mode mode(uint8_t tank) { return slots[tank < TANK_COUNT ? tank : 0].plan.mode(); }
+
+void preheatIn(uint8_t tank, uint32_t ms) {
+  if (tank >= TANK_COUNT) return;
+  slots[tank].plan.preheatAt(ms ? Timers::nowMs() + ms : 0);
+}
+
+void report() {
+  if (!STANDBY_IDLE_MS) return;
+  const uint64_t now = Timers::nowMs();
+  const int32_t  wm  = wallMin();
+  for (uint8_t i = 0; i < Tanks::COUNT; ++i) {
+    const StandbyPlanner& p = slots[i].plan;
+    const StandbyPlanner::Stats s = p.stats();
+    const uint32_t toReady = p.msToReady(now, wm);
+    const long     nextMin = toReady == StandbyPlanner::NONE ? -1 : (long)(toReady / 60000);
+    LOGI("[Standby] %s: %s, rate %.2f C/min (%lu learned), next ready in %ld min, standbys %lu, preheats %lu\n",
+         Tanks::at(i).name, StandbyPlanner::name(p.mode()), p.rateCPerMin(), (unsigned long)s.learned,
+         nextMin, (unsigned long)s.standbys, (unsigned long)s.preheats);
+  }
+}
+
+} // namespace Standby
@@ -0,0 +1,39 @@
+#pragma once
+#include <Arduino.h>
+#include "standby_planner.h"
+
+/*
+  Warm standby and scheduled preheat (STANDBY_IDLE_MS).
+  After STANDBY_IDLE_MS without operator input or a job (profile, manual
+  pump run) each tank's heater regulates to STANDBY_C instead of the
+  setpoint. Before the next shift in the STANDBY_SHIFT_* calendar, or a
+  one-off preheatIn() target, the bath is brought back early enough to be
+  at the setpoint when the shift starts (StandbyPlanner, warm-up rate
+  learned per tank).
+  - The planners run on the loop task (STANDBY_POLL_MS timer); the control
+    task only reads the setpoint override
+  - The calendar needs local time: SNTP over the fleet WiFi (FLEET_ENABLE).
+    Without a valid clock only standby and one-off targets work
+  Any input returns every tank to its setpoint at once.
+*/
+namespace Standby {
+
+/** Planners and the poll timer; SNTP when a calendar is set (after Fleet::begin()). */
+void begin();
+
+/** Operator input: leave standby / preheat, restart the idle time (loop task). */
+void activity();
+
+/** Setpoint override for a tank, NAN when not in standby (any task). */
+float setpointC(uint8_t tank);
+
+/** Current mode of a tank's planner. */
+StandbyPlanner::Mode mode(uint8_t tank);
+
+/** One-off target: have the tank at its setpoint `ms` from now (0 = cancel; loop task). */
+void preheatIn(uint8_t tank, uint32_t ms);
+
+/** Log mode, learned warm-up rate and counters per tank. */
+void report();
+
+} // namespace Standby
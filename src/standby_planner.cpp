@@ -0,0 +1,121 @@
+// Warm standby and scheduled preheat (see standby_planner.h)
+#include "standby_planner.h"
+#include <math.h>
+
+namespace {
+  constexpr float ARRIVED_C = 0.5f;   // a warm-up ends this close to its target
+}
+
+StandbyPlanner::StandbyPlanner(const Policy& p, Shift s)
+  : policy_(p), shift_(s), rateCPerMin_(p.rateInitCPerMin) {}
+
+void StandbyPlanner::activity(uint64_t now) {
+  activeMs_ = now;
+  if (mode_ != Mode::Ready) enter(Mode::Ready);
+}
+
+void StandbyPlanner::enter(Mode m) {
+  if (m == Mode::Standby) {
+    st_.standbys++;
+    warming_ = false;   // cooling down, nothing to learn
+  }
+  if (m == Mode::Preheat) st_.preheats++;
+  mode_ = m;
+}
+
+// Warm-ups toward the operator setpoint (recovery from standby, preheat,
+// a cold start) give the rate; short ones are mostly hold-time noise
+void StandbyPlanner::learn(uint64_t now, float bathC, float setpointC) {
+  if (isnan(bathC) || mode_ == Mode::Standby) {
+    warming_ = false;
+    return;
+  }
+  if (!warming_) {
+    if (setpointC - bathC >= policy_.learnMinC) {
+      warming_ = true;
+      warmMs_  = now;
+      warmC_   = bathC;
+    }
+    return;
+  }
+  if (bathC < setpointC - ARRIVED_C) return;
+  warming_ = false;
+  const float    dC = bathC - warmC_;
+  const uint64_t dt = now - warmMs_;
+  if (dC < policy_.learnMinC || dt < 60000) return;
+  const float r = dC / (dt / 60000.0f);
+  rateCPerMin_ = st_.learned ? rateCPerMin_ + policy_.learnAlpha * (r - rateCPerMin_) : r;
+  st_.learned++;
+}
+
+uint32_t StandbyPlanner::leadMs(float bathC, float setpointC) const {
+  const float from    = isnan(bathC) ? policy_.standbyC : bathC;
+  const float deficit = setpointC - from;
+  float ms = (float)policy_.marginMs;
+  if (deficit > 0.0f && rateCPerMin_ > 0.0f) ms += deficit / rateCPerMin_ * 60000.0f;
+  return ms >= (float)(NONE - 1) ? NONE - 1 : (uint32_t)ms;
+}
+
+uint32_t StandbyPlanner::msToReady(uint64_t now, int32_t wallMin) const {
+  uint64_t best = NONE;
+  if (readyAtMs_ > now) best = readyAtMs_ - now;
+  if (shift_.days && wallMin >= 0) {
+    const int32_t day = wallMin / (24 * 60);
+    for (int32_t d = 0; d <= 7; ++d) {
+      if (!(shift_.days & (1u << ((day + d) % 7)))) continue;
+      const int32_t t = (day + d) * 24 * 60 + shift_.startMin - wallMin;
+      if (t <= 0) continue;   // today's start has passed
+      const uint64_t ms = (uint64_t)t * 60000;
+      if (ms < best) best = ms;
+      break;
+    }
+  }
+  return best >= NONE ? NONE : (uint32_t)best;
+}
+
+void StandbyPlanner::update(uint64_t now, int32_t wallMin, float bathC, float setpointC, bool busy) {
+  setpointC_ = setpointC;
+  learn(now, bathC, setpointC);
+  if (busy) activity(now);
+  if (readyAtMs_ && readyAtMs_ <= now && mode_ != Mode::Preheat) readyAtMs_ = 0;
+
+  const uint32_t toReady = msToReady(now, wallMin);
+  const uint32_t lead    = leadMs(bathC, setpointC);
+  switch (mode_) {
+    case Mode::Ready:
+      // No point cooling down if the next shift is already within reach
+      if (policy_.idleMs && now - activeMs_ >= policy_.idleMs && (toReady == NONE || toReady > lead)) {
+        enter(Mode::Standby);
+      }
+      break;
+    case Mode::Standby:
+      if (toReady != NONE && toReady <= lead) {
+        targetMs_ = now + toReady;
+        enter(Mode::Preheat);
+      }
+      break;
+    case Mode::Preheat:
+      if (now >= targetMs_) {
+        st_.lastArrivalC = isnan(bathC) ? NAN : bathC - setpointC;
+        if (readyAtMs_ <= now) readyAtMs_ = 0;
+        activeMs_ = now;   // the shift starts: a full idle period before standby again
+        enter(Mode::Ready);
+      }
+      break;
+  }
+}
+
+float StandbyPlanner::overrideC() const {
+  if (mode_ != Mode::Standby) return NAN;
+  // Never above the operator's setpoint
+  return isnan(setpointC_) || policy_.standbyC < setpointC_ ? policy_.standbyC : setpointC_;
+}
+
+const char* StandbyPlanner::name(Mode m) {
+  switch (m) {
+    case Mode::Ready:   return "ready";
+    case Mode::Standby: return "standby";
+    case Mode::Preheat: return "preheat";
+  }
+  return "?";
+}
@@ -0,0 +1,94 @@
+#pragma once
+// Warm standby and scheduled preheat for one bath (clock-independent core)
+//
+// Between jobs the bath is held at a lower standby temperature. Before the
+// next shift starts (a weekly calendar, or a one-off "ready at" time) the
+// planner leaves standby early enough that the bath reaches the etch
+// setpoint when the shift starts:
+//   lead = (setpoint - bath) / learned warm-up rate + margin
+// The warm-up rate is learned from every warm-up of at least learnMinC
+// (EWMA), so it follows the heater, the bath volume and the power budget.
+// Time comes in as arguments (monotonic ms, minute of the week), so the
+// same code runs against a simulated clock: see tools/preheat_sim.
+
+#include <math.h>
+#include <stdint.h>
+
+class StandbyPlanner {
+public:
+  enum class Mode : uint8_t { Ready, Standby, Preheat };
+
+  struct Policy {
+    float    standbyC;         // hold temperature between jobs
+    uint32_t idleMs;           // Ready without activity this long -> Standby (0 = never)
+    uint32_t marginMs;         // preheat starts this much before the estimate says
+    float    rateInitCPerMin;  // warm-up rate until one was learned
+    float    learnAlpha;       // weight of a new warm-up in the rate
+    float    learnMinC;        // shorter warm-ups are not learned
+  };
+
+  /** Weekly shift calendar: days bit 0 = Sunday .. bit 6 = Saturday, start in minutes after midnight. */
+  struct Shift {
+    uint8_t  days;
+    uint16_t startMin;
+  };
+
+  struct Stats {
+    uint32_t standbys;      // Ready -> Standby transitions
+    uint32_t preheats;      // preheats started
+    uint32_t learned;       // warm-ups learned
+    float    lastArrivalC;  // bath - setpoint when the last preheat target time came
+  };
+
+  static constexpr uint32_t NONE = UINT32_MAX;
+  static constexpr int32_t  NO_WALL_CLOCK = -1;
+  static constexpr int32_t  MIN_PER_WEEK  = 7 * 24 * 60;
+
+  StandbyPlanner(const Policy& p, Shift s);
+
+  /** Operator input or a job: back to Ready, the idle time restarts. */
+  void activity(uint64_t now);
+
+  /** One-off target: be at the setpoint at `readyMs` (monotonic; 0 = cancel). */
+  void preheatAt(uint64_t readyMs) { readyAtMs_ = readyMs; }
+
+  /**
+   * Plan one step (any period; seconds are plenty). wallMin = minutes since
+   * Sunday 00:00 local time, or NO_WALL_CLOCK. `busy` counts as activity.
+   */
+  void update(uint64_t now, int32_t wallMin, float bathC, float setpointC, bool busy);
+
+  /** Setpoint override: the standby temperature in Standby, NAN otherwise. */
+  float overrideC() const;
+
+  Mode  mode() const { return mode_; }
+  float rateCPerMin() const { return rateCPerMin_; }
+  Stats stats() const { return st_; }
+
+  /** Estimated time from `bathC` to `setpointC` at the learned rate, plus the margin. */
+  uint32_t leadMs(float bathC, float setpointC) const;
+
+  /** Time to the next shift start or one-off target (NONE if neither). */
+  uint32_t msToReady(uint64_t now, int32_t wallMin) const;
+
+  static const char* name(Mode m);
+
+private:
+  void enter(Mode m);
+  void learn(uint64_t now, float bathC, float setpointC);
+
+  const Policy policy_;
+  const Shift  shift_;
+  Mode     mode_       = Mode::Ready;
+  uint64_t activeMs_   = 0;       // last activity
+  uint64_t readyAtMs_  = 0;       // one-off target (0 = none)
+  uint64_t targetMs_   = 0;       // the running preheat aims here
+  float    setpointC_  = NAN;     // operator setpoint at the last update()
+  float    rateCPerMin_;
+  Stats    st_{};
+
+  // Warm-up being measured
+  bool     warming_    = false;
+  uint64_t warmMs_     = 0;
+  float    warmC_      = 0.0f;
+};
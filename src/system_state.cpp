@@ -0,0 +1,42 @@
+// Seqlock-published controller snapshot (see system_state.h)
+#include "system_state.h"
+#include "seqlock.h"
+#include "config.h"
+
+namespace {
+  SeqLock<SystemState> shared[TANK_COUNT];
+  SystemState          last[TANK_COUNT]{};   // publisher-side copies for change detection
+
+  bool sameView(const SystemState& a, const SystemState& b) {
+    return a.tempRaw       == b.tempRaw
+        && a.setpointRaw   == b.setpointRaw
+        && a.hysteresisRaw == b.hysteresisRaw
+        && a.sheathRaw     == b.sheathRaw   // not the target: its I term moves every tick
+        && a.heaterEnabled == b.heaterEnabled
+        && a.relayOn       == b.relayOn
+        && a.pumpOn        == b.pumpOn
+        && a.pumpFlow      == b.pumpFlow
+        && a.pumpTrip      == b.pumpTrip
+        && a.profileState  == b.profileState
+        && a.profileSeg    == b.profileSeg
+        && a.standby       == b.standby
+        && a.fault         == b.fault
+        && a.sensorPresent == b.sensorPresent;
+  }
+}
+
+namespace SharedState {
+
+bool publish(uint8_t tank, const SystemState& s) {
+  if (tank >= TANK_COUNT) return false;
+  SystemState& l = last[tank];
+  const bool changed = l.version == 0 || !sameView(l, s);
+  l         = s;
+  l.version = shared[tank].version() + 1;
+  shared[tank].write(l);
+  return changed;
+}
+
+SystemState read(uint8_t tank) { return shared[tank < TANK_COUNT ? tank : 0].read(); }
+
+} // namespace SharedState
@@ -0,0 +1,44 @@
+#pragma once
+#include <Arduino.h>
+#include "temp_fixed.h"
+
+/**
+ * One consistent view of a tank's controller, published by the control
+ * task once per tick (one snapshot per tank). UI, telemetry or network code on any task or core reads a
+ * whole snapshot instead of calling the modules one field at a time, so it
+ * never sees e.g. a relay state from one tick with a setpoint from another.
+ */
+struct SystemState {
+  uint32_t version;        // publish counter (0 = nothing published yet)
+  uint64_t atMs;           // Timers::nowMs() of the tick that produced it
+  // Temperatures in 1/16 °C (Temp::Raw, see temp_fixed.h)
+  Temp::Raw tempRaw;         // bath temperature, Temp::NONE if no valid reading
+  Temp::Raw setpointRaw;     // effective: the running profile's ramped setpoint, the standby temperature, else the operator's
+  Temp::Raw hysteresisRaw;
+  Temp::Raw sheathRaw;       // heater sheath probe, Temp::NONE without one (bath-only control)
+  Temp::Raw sheathTargetRaw; // cascade outer loop output, Temp::NONE when not cascading
+  bool     heaterEnabled;
+  bool     relayOn;
+  bool     pumpOn;
+  uint8_t  pumpFlow;       // Pump::FlowState (tach flow health)
+  uint8_t  pumpTrip;       // Pump::Trip (latched current-monitor trip)
+  uint8_t  profileState;   // Profile::State
+  uint8_t  profileSeg;     // segment of a running profile (0-based)
+  uint8_t  standby;        // StandbyPlanner::Mode
+  uint8_t  fault;          // ThermalGuard::Fault (latched, heater held off)
+  bool     sensorPresent;
+};
+
+namespace SharedState {
+
+/**
+ * Publish a new snapshot (control task only; `version` is filled in).
+ * Returns true if anything other than the timestamp changed, so the caller
+ * can wake consumers only when there is something new to show.
+ */
+bool publish(uint8_t tank, const SystemState& s);
+
+/** Latest snapshot of a tank; wait-free for the publisher, readers retry on overlap. */
+SystemState read(uint8_t tank = 0);
+
+} // namespace SharedState
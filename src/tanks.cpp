@@ -0,0 +1,77 @@
+// Tank instances (pins from config.h, outputs from actuators.h)
+#include "tanks.h"
+#include "actuators.h"
+
+namespace {
+  // No-rise window from this bath's heater and volume
+  ThermalGuard::Policy guardPolicy(uint16_t heaterW, float volumeL) {
+    return { ThermalGuard::riseWindowMs(heaterW, volumeL, GUARD_RISE_MIN_C, GUARD_RISE_EFF_PCT, GUARD_PROBE_LAG_MS),
+             Temp::fromC(GUARD_RISE_MIN_C), GUARD_STUCK_ON_MS, (uint16_t)(GUARD_RATE_MAX_C_PER_S * Temp::ONE_C),
+             Temp::fromC(GUARD_DISAGREE_C), GUARD_DISAGREE_MS };
+  }
+}
+
+Tank::Tank(const char* n, uint8_t probePin, TempProbe* checkProbe, TempProbe* sheathProbe, Hal::OutRef relay,
+           Hal::OutRef pumpGate, uint8_t pumpLedcCh, int8_t pumpTachPin, uint8_t pumpPcntUnit,
+           float volumeL, uint16_t hW, uint16_t pW)
+  : name(n), probe(probePin), check(checkProbe), sheath(sheathProbe), heater(relay), guard(guardPolicy(hW, volumeL)),
+    pump(pumpGate, pumpLedcCh, pumpTachPin, pumpPcntUnit), circ(n, pump, volumeL), heaterW(hW), pumpW(pW) {}
+
+void Tank::begin() {
+  LOGI("[Tank] %s: heater %u W, pump %u W, turnover %lu s, no-rise window %lu s%s%s\n", name, heaterW, pumpW,
+       (unsigned long)(circ.turnoverMs() / 1000), (unsigned long)(guard.policy().riseWindowMs / 1000),
+       check ? ", check probe" : "", sheath ? ", sheath probe" : "");
+  probe.begin();
+  if (check)  check->begin();
+  if (sheath) sheath->begin();
+  heater.begin();
+  pump.begin();
+}
+
+namespace {
+  // Optional second probe per bath and heater sheath probe, each on its own 1-Wire pin
+#if TS_CHECK_PIN >= 0
+  TempProbe check0(TS_CHECK_PIN);
+  constexpr TempProbe* CHECK0 = &check0;
+#else
+  constexpr TempProbe* CHECK0 = nullptr;
+#endif
+#if TANK_COUNT > 1 && TANK1_TS_CHECK_PIN >= 0
+  TempProbe check1(TANK1_TS_CHECK_PIN);
+  constexpr TempProbe* CHECK1 = &check1;
+#else
+  constexpr TempProbe* CHECK1 = nullptr;
+#endif
+#if TS_SHEATH_PIN >= 0
+  TempProbe sheath0(TS_SHEATH_PIN);
+  constexpr TempProbe* SHEATH0 = &sheath0;
+#else
+  constexpr TempProbe* SHEATH0 = nullptr;
+#endif
+#if TANK_COUNT > 1 && TANK1_TS_SHEATH_PIN >= 0
+  TempProbe sheath1(TANK1_TS_SHEATH_PIN);
+  constexpr TempProbe* SHEATH1 = &sheath1;
+#else
+  constexpr TempProbe* SHEATH1 = nullptr;
+#endif
+
+  Tank tanks[] = {
+    Tank("Etch", TS_PIN, CHECK0, SHEATH0, Hal::outRef<HeaterRelay>(), Hal::outRef<PumpGate>(), PUMP_LEDC_CH,
+         PIN_PUMP_TACH, PUMP_PCNT_UNIT, TANK_VOLUME_L, HEATER_W, PUMP_W),
+#if TANK_COUNT > 1
+    Tank("Tin",  TANK1_TS_PIN, CHECK1, SHEATH1, Hal::outRef<Tank1Relay>(), Hal::outRef<Tank1PumpGate>(), TANK1_PUMP_LEDC_CH,
+         TANK1_PUMP_TACH_PIN, TANK1_PUMP_PCNT_UNIT, TANK1_VOLUME_L, TANK1_HEATER_W, TANK1_PUMP_W),
+#endif
+  };
+  static_assert(sizeof(tanks) / sizeof(tanks[0]) == TANK_COUNT, "TANK_COUNT must be 1 or 2");
+}
+
+namespace Tanks {
+
+Tank& at(uint8_t i) { return tanks[i < COUNT ? i : 0]; }
+
+void begin() {
+  for (Tank& t : tanks) t.begin();
+}
+
+} // namespace Tanks
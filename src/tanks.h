@@ -0,0 +1,49 @@
+#pragma once
+#include <Arduino.h>
+#include "config.h"
+#include "sensor_ds18b20.h"
+#include "heater_controller.h"
+#include "pump.h"
+#include "circulation.h"
+#include "profile.h"
+#include "thermal_guard.h"
+
+/**
+ * One bath: its own probe, heater relay and pump. All tanks are ticked by
+ * the same control task and publish their own SystemState snapshot; the
+ * loop task runs each pump from its heater through Circulation. An
+ * optional second probe in the bath lets the ThermalGuard cross-check, and
+ * one on the heater sheath runs the heater in cascade.
+ */
+struct Tank {
+  const char*      name;
+  TempProbe        probe;
+  TempProbe* const check;     // second probe in the bath, or nullptr
+  TempProbe* const sheath;    // probe on the heater sheath (cascade), or nullptr
+  HeaterController heater;
+  ThermalGuard     guard;     // fault detectors, run by the control task
+  Profile          profile;   // ramp/soak setpoint, run by the control task
+  Pump             pump;
+  Circulation      circ;
+  const uint16_t   heaterW;   // ratings for the mains power budget
+  const uint16_t   pumpW;
+
+  Tank(const char* name, uint8_t probePin, TempProbe* checkProbe, TempProbe* sheathProbe, Hal::OutRef relay,
+       Hal::OutRef pumpGate, uint8_t pumpLedcCh, int8_t pumpTachPin, uint8_t pumpPcntUnit,
+       float volumeL, uint16_t heaterW, uint16_t pumpW);
+
+  /** Start probes, relay (OFF) and pump (stopped). */
+  void begin();
+};
+
+namespace Tanks {
+
+constexpr uint8_t COUNT = TANK_COUNT;
+
+/** Tank by index (0 = etch bath, shown on the status page at boot). */
+Tank& at(uint8_t i);
+
+/** begin() every tank. */
+void begin();
+
+} // namespace Tanks
@@ -0,0 +1,34 @@
+#pragma once
+#include <math.h>
+#include <stdint.h>
+
+/**
+ * Fixed-point temperatures: int16 in 1/16 °C, the DS18B20's own scratchpad
+ * format (-55..125 °C = -880..2000). The probe -> controller -> snapshot ->
+ * display path carries these, so the relay decision is a few integer
+ * compares and never touches the FPU: safe from an ISR or esp_timer
+ * callback, where the ESP32 does not save FPU state. Float conversions
+ * remain at the edges (operator setpoint, profile, logs).
+ */
+namespace Temp {
+
+using Raw = int16_t;
+
+constexpr Raw NONE  = INT16_MIN;   // no valid reading (the float path's NAN)
+constexpr Raw ONE_C = 16;
+
+/** °C -> raw, rounded to the nearest 1/16 (task context or compile time). */
+constexpr Raw fromC(float c) { return (Raw)(c >= 0.0f ? c * ONE_C + 0.5f : c * ONE_C - 0.5f); }
+
+/** raw -> °C, NAN for NONE (logs and float consumers). */
+inline float toC(Raw r) { return r == NONE ? NAN : r / (float)ONE_C; }
+
+/** raw -> whole °C, rounded half away from zero (integer only). */
+constexpr int whole(Raw r) { return r >= 0 ? (r + ONE_C / 2) / ONE_C : -((-r + ONE_C / 2) / ONE_C); }
+
+/** raw -> 0.1 °C, rounded half away from zero (integer only). */
+constexpr int16_t deci(Raw r) {
+  return (int16_t)(r >= 0 ? (r * 10 + ONE_C / 2) / ONE_C : -((-r * 10 + ONE_C / 2) / ONE_C));
+}
+
+} // namespace Temp
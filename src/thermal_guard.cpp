@@ -0,0 +1,98 @@
+// Heater fault detectors (see thermal_guard.h)
+#include "thermal_guard.h"
+
+namespace {
+  constexpr float WATER_J_PER_L_K = 4186.0f;
+}
+
+uint32_t ThermalGuard::riseWindowMs(uint16_t heaterW, float volumeL, float riseMinC,
+                                    uint8_t effPct, uint32_t lagMs) {
+  const float cPerS = heaterW * (effPct / 100.0f) / (volumeL * WATER_J_PER_L_K);
+  return (uint32_t)(riseMinC / cPerS * 1000.0f) + lagMs;
+}
+
+void ThermalGuard::trip(Fault f, int32_t detail) {
+  fault_  = f;
+  detail_ = detail;
+  trips_++;
+}
+
+// Start every detector from scratch (reset, or after a gap in the readings)
+void ThermalGuard::rearm() {
+  onSinceMs_    = 0;
+  last_         = Temp::NONE;
+  stuckOnMs_    = 0;
+  apartSinceMs_ = 0;
+}
+
+ThermalGuard::Fault ThermalGuard::check(uint64_t now, Temp::Raw bath, Temp::Raw check, bool heaterOn) {
+  if (resetReq_.exchange(false, std::memory_order_acq_rel)) {
+    fault_  = Fault::None;
+    detail_ = 0;
+    rearm();
+  }
+  const uint32_t dt = lastMs_ ? (uint32_t)(now - lastMs_) : 0;
+  lastMs_ = now;
+  if (fault_ != Fault::None) return fault_;
+  if (bath == Temp::NONE) {   // the controller already stops without a reading
+    rearm();
+    return fault_;
+  }
+
+  // Rate and Stuck work on changes of the reading (one per conversion at most)
+  if (bath != last_) {
+    if (last_ != Temp::NONE) {
+      // The change happened somewhere since the last one: the rate is at least this
+      const int32_t  step = bath > last_ ? bath - last_ : last_ - bath;
+      const uint32_t ms   = now > changedMs_ ? (uint32_t)(now - changedMs_) : 1;
+      if ((uint64_t)step * 1000 > (uint64_t)policy_.rateMaxPerS * ms) {
+        trip(Fault::Rate, (int32_t)((uint64_t)step * 1000 / ms));
+        return fault_;
+      }
+    }
+    last_      = bath;
+    changedMs_ = now;
+    stuckOnMs_ = 0;
+  } else if (heaterOn) {
+    stuckOnMs_ += dt;
+    if (stuckOnMs_ >= policy_.stuckOnMs) {
+      trip(Fault::Stuck, bath);
+      return fault_;
+    }
+  }
+
+  // NoRise: the window slides on with every riseMin gained
+  if (!heaterOn) {
+    onSinceMs_ = 0;
+  } else if (!onSinceMs_ || bath - onMin_ >= policy_.riseMin) {
+    onSinceMs_ = now;
+    onMin_     = bath;
+  } else {
+    if (bath < onMin_) onMin_ = bath;
+    if (now - onSinceMs_ >= policy_.riseWindowMs) {
+      trip(Fault::NoRise, bath - onMin_);
+      return fault_;
+    }
+  }
+
+  const int32_t apart = check == Temp::NONE ? 0 : bath - check;
+  if (apart <= policy_.disagree && -apart <= policy_.disagree) {
+    apartSinceMs_ = 0;
+  } else if (!apartSinceMs_) {
+    apartSinceMs_ = now;
+  } else if (now - apartSinceMs_ >= policy_.disagreeMs) {
+    trip(Fault::Disagree, apart);
+  }
+  return fault_;
+}
+
+const char* ThermalGuard::name(Fault f) {
+  switch (f) {
+    case Fault::None:     return "ok";
+    case Fault::NoRise:   return "no rise";
+    case Fault::Stuck:    return "stuck probe";
+    case Fault::Rate:     return "implausible rate";
+    case Fault::Disagree: return "probes disagree";
+  }
+  return "?";
+}
@@ -0,0 +1,84 @@
+#pragma once
+// Heater fault detection for one bath (clock-independent core)
+//
+// HeaterController stops at NAN and HEATER_MAX_TEMP_C, which a probe lying
+// next to the tank never reaches while the heater boils the bath dry. The
+// guard looks at how the readings behave instead, each detector with its
+// own trip code and a bounded latency:
+//   NoRise   heater on for riseWindowMs without riseMinC of rise (probe out
+//            of the bath, open heater): latency riseWindowMs
+//   Stuck    the reading did not change a single LSB while the heater was
+//            on for stuckOnMs in total: latency stuckOnMs of heating
+//   Rate     two readings further apart than rateMaxCPerS allows (a bath
+//            can't do that; a glitching or dislodged probe can): one conversion
+//   Disagree bath and check probe more than disagreeC apart for
+//            disagreeMs (only with a second probe in the bath)
+// A trip latches until reset; the caller keeps the heater off meanwhile.
+// Time comes in as an argument, like StandbyPlanner and FleetArbiter.
+// Readings stay in the probe's 1/16 °C and check() is integer-only.
+
+#include <atomic>
+#include <stdint.h>
+#include "temp_fixed.h"
+
+class ThermalGuard {
+public:
+  enum class Fault : uint8_t { None, NoRise, Stuck, Rate, Disagree };
+
+  struct Policy {
+    uint32_t  riseWindowMs;  // continuous heating before riseMin must show
+    Temp::Raw riseMin;
+    uint32_t  stuckOnMs;     // heater on-time without any change in the reading
+    uint16_t  rateMaxPerS;   // fastest plausible change between readings (1/16 °C per s)
+    Temp::Raw disagree;      // bath vs check probe
+    uint32_t  disagreeMs;
+  };
+
+  /**
+   * Rise window for a heater and bath: the time riseMinC takes at effPct
+   * of the heater's power going into the water, plus the probe lag.
+   */
+  static uint32_t riseWindowMs(uint16_t heaterW, float volumeL, float riseMinC,
+                               uint8_t effPct, uint32_t lagMs);
+
+  explicit ThermalGuard(const Policy& p) : policy_(p) {}
+
+  /**
+   * One control tick. `bath` is the control probe, `check` a second probe
+   * in the same bath (Temp::NONE if none), `heaterOn` true while heating
+   * (the relay, or a cascade asking for full heat). Returns the latched fault.
+   */
+  Fault check(uint64_t now, Temp::Raw bath, Temp::Raw check, bool heaterOn);
+
+  /** Clear a trip on the next check() (any task). */
+  void requestReset() { resetReq_.store(true, std::memory_order_release); }
+
+  Fault    fault()  const { return fault_; }
+  /** What tripped: rise (°C), stuck reading (°C), rate (°C/s) or difference (°C). */
+  float    detail() const { return detail_ / (float)Temp::ONE_C; }
+  uint32_t trips()  const { return trips_; }
+  const Policy& policy() const { return policy_; }
+
+  static const char* name(Fault f);
+
+private:
+  void trip(Fault f, int32_t detail);
+  void rearm();
+
+  const Policy      policy_;
+  std::atomic<bool> resetReq_{false};
+  volatile Fault    fault_  = Fault::None;
+  int32_t           detail_ = 0;      // 1/16 °C (per s)
+  uint32_t          trips_  = 0;
+  uint64_t          lastMs_ = 0;
+
+  // NoRise: continuous heating and the lowest reading since
+  uint64_t  onSinceMs_   = 0;   // 0 = heater off or no reading
+  Temp::Raw onMin_       = Temp::NONE;
+  // Stuck / Rate: last change of the reading
+  Temp::Raw last_        = Temp::NONE;
+  uint64_t changedMs_   = 0;
+  uint32_t stuckOnMs_   = 0;
+  // Disagree
+  uint64_t apartSinceMs_ = 0;  // 0 = probes agree
+};
@@ -0,0 +1,261 @@
+// Hierarchical timer wheel (see timers.h)
+//
+// A timer sits on the lowest level whose slot range still contains both the
+// wheel time (`cur`) and its expiry: level 0 holds expiries in the current
+// 64 ms block, level 1 those in the current 4096 ms block, and so on. When
+// the wheel reaches the start of an upper-level slot, that slot is cascaded
+// (re-inserted relative to the new time) until its timers land on level 0
+// and fire at their exact millisecond. Empty stretches are skipped in one
+// step using the occupancy bitmaps, so a long sleep costs nothing extra.
+#include "timers.h"
+#include "config.h"
+#include "scheduler.h"
+
+#include <esp_timer.h>
+
+namespace {
+  constexpr uint8_t  LVL_BITS = 6;
+  constexpr uint8_t  SLOTS    = 1 << LVL_BITS;
+  constexpr uint8_t  LEVELS   = 4;
+  constexpr uint16_t NIL      = 0xFFFF;
+  constexpr uint64_t NO_TICK  = UINT64_MAX;
+
+  static_assert(TIMERS_MAX < NIL, "timer pool index must fit in 16 bits");
+
+  struct Node {
+    uint64_t         expiry;
+    uint32_t         period;   // 0 = one-shot
+    Timers::Callback cb;
+    void*            arg;
+    uint16_t         prev, next;
+    uint16_t         gen;      // bumped on release: stale Ids no longer match
+    uint8_t          level, slot;
+    bool             used;
+  };
+
+  Node         pool[TIMERS_MAX];
+  uint16_t     freeHead = NIL;
+  uint16_t     head[LEVELS][SLOTS];
+  uint64_t     occupied[LEVELS];  // bit s set = slot s non-empty
+  uint64_t     cur = 0;           // every expiry <= cur has fired
+  Timers::Stats st{};
+  portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+
+  inline Timers::Id idOf(uint16_t i) { return ((uint32_t)pool[i].gen << 16) | (uint32_t)(i + 1); }
+
+  // Pool index for a live Id, NIL if stale or invalid
+  inline uint16_t indexOf(Timers::Id id) {
+    const uint32_t i = (id & 0xFFFF) - 1;
+    if (id == Timers::NONE || i >= TIMERS_MAX) return NIL;
+    const Node& n = pool[i];
+    return (n.used && n.gen == (id >> 16)) ? (uint16_t)i : NIL;
+  }
+
+  void link(uint16_t i) {
+    Node& n = pool[i];
+    const uint64_t diff = n.expiry ^ cur;
+    uint8_t lvl = 0;
+    while (lvl < LEVELS - 1 && (diff >> (LVL_BITS * (lvl + 1)))) ++lvl;
+    n.level = lvl;
+    n.slot  = (uint8_t)((n.expiry >> (LVL_BITS * lvl)) & (SLOTS - 1));
+    n.prev  = NIL;
+    n.next  = head[lvl][n.slot];
+    if (n.next != NIL) pool[n.next].prev = i;
+    head[lvl][n.slot] = i;
+    occupied[lvl] |= 1ULL << n.slot;
+  }
+
+  void unlink(uint16_t i) {
+    Node& n = pool[i];
+    if (n.prev != NIL) pool[n.prev].next = n.next;
+    else               head[n.level][n.slot] = n.next;
+    if (n.next != NIL) pool[n.next].prev = n.prev;
+    if (head[n.level][n.slot] == NIL) occupied[n.level] &= ~(1ULL << n.slot);
+  }
+
+  void release(uint16_t i) {
+    Node& n = pool[i];
+    n.used = false;
+    n.gen++;
+    n.next = freeHead;
+    freeHead = i;
+    st.inUse--;
+  }
+
+  // Move every timer of an upper-level slot down relative to `cur`
+  void cascade(uint8_t lvl, uint8_t slot) {
+    uint16_t i = head[lvl][slot];
+    head[lvl][slot] = NIL;
+    occupied[lvl] &= ~(1ULL << slot);
+    while (i != NIL) {
+      const uint16_t nx = pool[i].next;
+      link(i);
+      st.cascaded++;
+      i = nx;
+    }
+  }
+
+  inline uint64_t rotr(uint64_t x, uint8_t r) { return r ? (x >> r) | (x << (64 - r)) : x; }
+
+  // Earliest wheel time with work: a level-0 expiry or an upper-level slot
+  // start (cascade). Lower levels only hold slots ahead of `cur` within
+  // their parent block; the top level wraps around.
+  uint64_t nextTick() {
+    uint64_t best = NO_TICK;
+    for (uint8_t lvl = 0; lvl < LEVELS; ++lvl) {
+      if (!occupied[lvl]) continue;
+      const uint8_t sh  = LVL_BITS * lvl;
+      const uint8_t idx = (uint8_t)((cur >> sh) & (SLOTS - 1));
+      uint64_t t;
+      if (lvl < LEVELS - 1) {
+        const uint64_t ahead = occupied[lvl] & ~((2ULL << idx) - 1);
+        if (!ahead) continue;
+        const uint8_t  psh  = sh + LVL_BITS;
+        t = ((cur >> psh) << psh) + ((uint64_t)__builtin_ctzll(ahead) << sh);
+      } else {
+        const uint8_t k = (uint8_t)__builtin_ctzll(rotr(occupied[lvl], (idx + 1) & (SLOTS - 1))) + 1;
+        t = ((cur >> sh) + k) << sh;
+      }
+      if (t < best) best = t;
+    }
+    return best;
+  }
+
+  Timers::Id arm(uint64_t when, uint32_t period, Timers::Callback cb, void* arg) {
+    if (!cb) return Timers::NONE;
+    portENTER_CRITICAL(&mux);
+    const uint16_t i = freeHead;
+    if (i == NIL) {
+      st.exhausted++;
+      portEXIT_CRITICAL(&mux);
+      LOGE("[Timers] Pool exhausted (TIMERS_MAX=%d)\n", TIMERS_MAX);
+      return Timers::NONE;
+    }
+    freeHead = pool[i].next;
+    Node& n  = pool[i];
+    n.used   = true;
+    n.expiry = when > cur ? when : cur + 1;
+    n.period = period;
+    n.cb     = cb;
+    n.arg    = arg;
+    link(i);
+    st.armed++;
+    if (++st.inUse > st.peak) st.peak = st.inUse;
+    const Timers::Id id = idOf(i);
+    portEXIT_CRITICAL(&mux);
+    // The loop may already be asleep on an older deadline
+    if (!Sched::inLoop()) Sched::wake();
+    return id;
+  }
+}
+
+namespace Timers {
+
+uint64_t nowMs() { return (uint64_t)esp_timer_get_time() / 1000; }
+
+void begin() {
+  portENTER_CRITICAL(&mux);
+  for (uint8_t l = 0; l < LEVELS; ++l) {
+    occupied[l] = 0;
+    for (uint8_t s = 0; s < SLOTS; ++s) head[l][s] = NIL;
+  }
+  for (uint16_t i = 0; i < TIMERS_MAX; ++i) {
+    pool[i].used = false;
+    pool[i].gen  = 1;
+    pool[i].next = (i + 1 < TIMERS_MAX) ? i + 1 : NIL;
+  }
+  freeHead = 0;
+  st       = {};
+  cur      = nowMs();
+  portEXIT_CRITICAL(&mux);
+}
+
+Id after(uint32_t ms, Callback cb, void* arg) { return arm(nowMs() + ms, 0, cb, arg); }
+Id at(uint64_t whenMs, Callback cb, void* arg) { return arm(whenMs, 0, cb, arg); }
+Id every(uint32_t periodMs, Callback cb, void* arg) {
+  if (!periodMs) periodMs = 1;
+  return arm(nowMs() + periodMs, periodMs, cb, arg);
+}
+
+bool cancel(Id& id) {
+  portENTER_CRITICAL(&mux);
+  const uint16_t i = indexOf(id);
+  if (i != NIL) {
+    unlink(i);
+    release(i);
+  }
+  portEXIT_CRITICAL(&mux);
+  id = NONE;
+  return i != NIL;
+}
+
+bool pending(Id id) {
+  portENTER_CRITICAL(&mux);
+  const bool live = indexOf(id) != NIL;
+  portEXIT_CRITICAL(&mux);
+  return live;
+}
+
+void run() {
+  const uint64_t now = nowMs();
+  for (;;) {
+    portENTER_CRITICAL(&mux);
+    const uint64_t t = nextTick();
+    if (t > now) {
+      cur = now;
+      portEXIT_CRITICAL(&mux);
+      return;
+    }
+    cur = t;
+    // Upper levels first: their timers may be due at exactly this tick
+    for (uint8_t lvl = LEVELS - 1; lvl >= 1; --lvl) {
+      const uint8_t sh = LVL_BITS * lvl;
+      if (t & ((1ULL << sh) - 1)) continue;
+      cascade(lvl, (uint8_t)((t >> sh) & (SLOTS - 1)));
+    }
+    portEXIT_CRITICAL(&mux);
+
+    // Fire this tick's slot one timer at a time, callbacks outside the lock
+    const uint8_t slot = (uint8_t)(t & (SLOTS - 1));
+    for (;;) {
+      portENTER_CRITICAL(&mux);
+      const uint16_t i = head[0][slot];
+      if (i == NIL) { portEXIT_CRITICAL(&mux); break; }
+      Node& n = pool[i];
+      unlink(i);
+      const Callback cb  = n.cb;
+      void* const    arg = n.arg;
+      if (n.period) {
+        // Drift-free re-arm; periods missed during a long stall are
+        // coalesced into this one callback (phase is kept)
+        n.expiry += n.period;
+        if (n.expiry <= now) n.expiry += ((now - n.expiry) / n.period + 1) * n.period;
+        link(i);
+      } else {
+        release(i);
+      }
+      st.fired++;
+      portEXIT_CRITICAL(&mux);
+      cb(arg);
+    }
+  }
+}
+
+uint32_t msUntilNext() {
+  portENTER_CRITICAL(&mux);
+  const uint64_t t = nextTick();
+  portEXIT_CRITICAL(&mux);
+  if (t == NO_TICK) return Sched::NEVER;
+  const uint64_t now = nowMs();
+  if (t <= now) return 0;
+  return (uint32_t)min<uint64_t>(t - now, Sched::NEVER - 1);
+}
+
+Stats stats() {
+  portENTER_CRITICAL(&mux);
+  const Stats s = st;
+  portEXIT_CRITICAL(&mux);
+  return s;
+}
+
+} // namespace Timers
@@ -0,0 +1,66 @@
+#pragma once
+#include <Arduino.h>
+
+/*
+  Hierarchical timer wheel: the single time base for all modules.
+  - Time is 64-bit milliseconds from esp_timer_get_time(), so deadlines
+    never wrap (millis() wraps after 49.7 days)
+  - 4 levels x 64 slots at 1 ms resolution cover ~4.6 h directly; longer
+    delays park on the top level and cascade down again. Arm and cancel are
+    O(1); the next expiry is found from per-level occupancy bitmaps
+  - Callbacks run from run() on the loop task, never from an ISR
+  - msUntilNext() is the loop's one "how long may I sleep" answer
+*/
+namespace Timers {
+
+using Callback = void (*)(void* arg);
+
+/** Timer handle. NONE = no timer; a fired or cancelled handle goes stale safely. */
+using Id = uint32_t;
+constexpr Id NONE = 0;
+
+struct Stats {
+  uint32_t armed;      // timers armed since boot
+  uint32_t fired;      // callbacks run (periodic timers count every period)
+  uint32_t cascaded;   // re-inserts from an upper level
+  uint32_t exhausted;  // arm requests refused because the pool was full
+  uint16_t inUse;      // timers currently armed
+  uint16_t peak;       // high-water mark of inUse (size TIMERS_MAX from this)
+};
+
+/** Monotonic milliseconds since boot (64-bit, no wrap). */
+uint64_t nowMs();
+
+/** Remaining time of a `period` that started at `since` (0 if elapsed). */
+inline uint32_t remaining(uint64_t since, uint32_t period, uint64_t now) {
+  const uint64_t elapsed = now - since;
+  return elapsed >= period ? 0 : (uint32_t)(period - elapsed);
+}
+
+/** Reset the wheel to the current time. Call once, before arming timers. */
+void begin();
+
+/** One-shot `ms` from now. Returns NONE if the pool is exhausted. */
+Id after(uint32_t ms, Callback cb, void* arg = nullptr);
+
+/** One-shot at absolute time `whenMs` (nowMs() scale); past times fire on the next run(). */
+Id at(uint64_t whenMs, Callback cb, void* arg = nullptr);
+
+/** Periodic, first expiry one period from now. Re-armed without drift. */
+Id every(uint32_t periodMs, Callback cb, void* arg = nullptr);
+
+/** Cancel a pending timer and clear `id`. Returns false if it was not pending. */
+bool cancel(Id& id);
+
+/** True while `id` is armed (for a one-shot: until its callback starts). */
+bool pending(Id id);
+
+/** Advance the wheel to now and run every expired callback. Call from loop(). */
+void run();
+
+/** Milliseconds until run() next has work (Sched::NEVER if nothing is armed). */
+uint32_t msUntilNext();
+
+Stats stats();
+
+} // namespace Timers
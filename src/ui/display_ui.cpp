@@ -7,54 +7,27 @@
 //
 // Notes
 // - Requires TFT_eSPI with FreeFonts enabled (LOAD_GFXFF=1).
-// - The layout assumes 320x240 landscape (set via build flags).
+// - Geometry comes from compile-time tables (layout.h) for UI_ROTATION;
+//   landscape 320x240 is the default.
 // - All colors come from config.h theme constants.
+// - Numeric values (temperatures, timer) are composed from the pre-rasterized
+//   glyph atlas and pushed as one block; ON/OFF and labels use FreeFonts.
 
 #include "display_ui.h"
+#include "glyph_atlas.h"
+#include "layout.h"
 #include "../config.h"
+#include "../timers.h"
+#include "../power.h"
+#include "../heap_watch.h"
 #include <TFT_eSPI.h>
-#include <math.h>
 // FreeFonts are included automatically by TFT_eSPI when LOAD_GFXFF=1
 
 namespace {
   TFT_eSPI tft;
 
-  // Cached layout metrics and coordinates for drawing
-  struct UI {
-    int16_t W,H, margin, radius, gap;
-    int16_t cardX, cardY, cardW, cardH;
-
-    // Columns
-    int16_t labelX, indentX, valueLeftX, valueX;
-
-    // Rows
-    int16_t titleY, dividerY; // top bar
-    // Heater block
-    int16_t heaterHdrY;
-    int16_t heaterStateY;
-    int16_t heaterTempsY; // current / goal
-    // Agitation block
-    int16_t agitHdrY;
-    int16_t agitStateY;
-
-    // Buttons
-    int16_t btnY, btnW, btnH, btnX;
-
-    // Time Remaining (now under Etch section)
-    int16_t timeLabelY, timeValueY; // legacy (bottom timer) not used
-
-    // Status (WiFi/MQTT)
-    int16_t statusY; // in header bar
-    int16_t statusRightX;
-
-    // Metrics
-    int16_t lineH, step, hdrPx, labelPx, valuePx, btnPx, timePx;
-    int16_t labelPxBig, valuePxBig; // for State/Temp/Power lines
-
-    // Etch section
-    int16_t etchHdrY;
-    int16_t etchTimeY;
-  } ui;
+  // Geometry for the configured rotation, resolved at compile time (layout.h)
+  constexpr UiLayout::Layout ui = UiLayout::forRotation<UI_ROTATION>();
 
   // Cache of last-drawn dynamic values to avoid unnecessary redraws (reduce flicker)
   struct Cache {
@@ -65,6 +38,8 @@ namespace {
     int      curTempI     = 0;   // rounded current temp (°C)
     int      setpointI    = 0;   // rounded setpoint (°C)
     uint32_t timeSec      = 0;   // remaining seconds
+    int16_t  tempW        = 0;   // last pushed atlas field widths
+    int16_t  timeW        = 0;
   } cache;
 
   // Legacy pixel-size mapper (kept for internal sizing; FreeFonts are used)
@@ -75,8 +50,9 @@ namespace {
     else if(px <= 60) tft.setTextFont(6);
     else tft.setTextFont(6);
   }
-  // Convenience wrapper to draw a string with datum and colors
-  void drawText(const String& s, int x, int y, uint16_t fg, uint16_t bg, int /*px*/, uint8_t datum){
+  // Convenience wrapper to draw a string with datum and colors (no String:
+  // literals and char buffers go straight to TFT_eSPI, no heap)
+  void drawText(const char* s, int x, int y, uint16_t fg, uint16_t bg, int /*px*/, uint8_t datum){
     tft.setTextDatum(datum);
     tft.setTextColor(fg, bg);
     tft.drawString(s, x, y);
@@ -85,78 +61,24 @@ namespace {
   // Font presets for a consistent look
   inline void useHeaderFont(){ tft.setFreeFont(&FreeSansBold9pt7b); }
   inline void useLabelFont() { tft.setFreeFont(&FreeSans9pt7b); }
-  inline void useValueFont() { tft.setFreeFont(&FreeMonoBold9pt7b); }
-  inline void useButtonFont(){ tft.setFreeFont(&FreeSansBold9pt7b); }
 
-  // Compute screen-dependent geometry. Safe margins prevent bezel clipping.
-  void layout(){
-    ui.W = tft.width();
-    ui.H = tft.height();
-
-    ui.margin = ui.W * 0.025;  // shrink light border for more usable space
-    ui.radius = ui.W * 0.030;  // slightly tighter corners
-    ui.gap    = ui.H * 0.012;
-
-    ui.cardX = ui.margin;
-    ui.cardY = ui.margin;
-    ui.cardW = ui.W - 2*ui.margin;
-    ui.cardH = ui.H - 2*ui.margin;
-
-    // Typography
-    ui.hdrPx      = ui.H * 0.064; // section headers
-    ui.labelPx    = ui.H * 0.047; // uniform, iets kleiner
-    ui.valuePx    = ui.H * 0.047;
-    ui.labelPxBig = ui.labelPx;   // gelijkgetrokken
-    ui.valuePxBig = ui.valuePx;
-    ui.btnPx      = ui.H * 0.043; // kleinere knoptekst
-    ui.timePx     = ui.valuePx;   // timer gelijk aan values
-    ui.lineH      = ui.H * 0.074;
-    ui.step       = ui.H * 0.092; // row spacing
-
-    // Columns
-    ui.labelX     = ui.cardX + ui.margin/2;
-    ui.indentX    = ui.labelX + (ui.W * 0.08);          // indentation under section headers
-    ui.valueX     = ui.cardX + ui.cardW - ui.margin - (ui.W * 0.09); // larger safe-right margin
-    ui.valueLeftX = ui.cardX + (ui.cardW * 0.52);       // left edge of value-clear area
-
-    // Rows (sections)
-    const int16_t top = ui.cardY + ui.margin; // inner top
-    ui.titleY      = 2; // exactly 2px from top edge to top of text (TC_DATUM)
-    // Divider exactly 2px below bottom of the header font
-    useHeaderFont();
-    int16_t hdrH = tft.fontHeight();
-    ui.dividerY    = ui.titleY + hdrH + 2;
-    ui.statusY     = ui.titleY; // align with title
-    ui.statusRightX= ui.cardX + ui.cardW - ui.margin;
-    
-    // Etch rows
-    ui.etchHdrY     = ui.dividerY + (ui.H * 0.05);
-    ui.etchTimeY    = ui.etchHdrY + ui.step;
-
-    // Heater rows
-    ui.heaterHdrY   = ui.etchHdrY + 2*ui.step;
-    ui.heaterStateY = ui.heaterHdrY + ui.step;
-    ui.heaterTempsY = ui.heaterHdrY + 2*ui.step;
-    // Agitation rows
-    ui.agitHdrY     = ui.heaterHdrY + 3*ui.step;
-    ui.agitStateY   = ui.agitHdrY + ui.step;
-
-    // Button (single, centered) absolute afstand tot onderrand: onderkant 2px boven schermrand
-    {
-      ui.btnW   = (ui.cardW * 0.38);
-      ui.btnH   = ui.H * 0.072 + 2; // +2 px taller
-      // Add more bottom space: 8px margin from bottom
-      ui.btnY   = ui.H - 8 - ui.btnH; // bottom = H-8
-      ui.btnX   = ui.cardX + (ui.cardW - ui.btnW)/2;
-      // legacy timer vars retained but unused for bottom timer
-      ui.timeLabelY = ui.btnY + ui.btnH + (ui.gap * 0.4);
-      ui.timeValueY = ui.btnY + ui.btnH + (ui.gap * 0.9);
-    }
+  // Header, right: the tank the controls act on (several tanks only)
+  const char* tankLabel  = nullptr;
+  int16_t     tankLabelW = 0;       // last drawn width, cleared on change
+  void drawTankLabel(){
+    if (tankLabelW) tft.fillRect(ui.statusRightX - tankLabelW, ui.statusY, tankLabelW, ui.dividerY - ui.statusY, COL_BG);
+    tankLabelW = 0;
+    if (!tankLabel) return;
+    useLabelFont();
+    drawText(tankLabel, ui.statusRightX, ui.statusY, COL_WHITE, COL_BG, ui.labelPx, TR_DATUM);
+    tankLabelW = tft.textWidth(tankLabel);
   }
+  inline void useValueFont() { tft.setFreeFont(&FreeMonoBold9pt7b); }
+  inline void useButtonFont(){ tft.setFreeFont(&FreeSansBold9pt7b); }
 
   // Faux-bold by overdrawing with small offsets
   // Faux-bold helper (simple multi-pass draw)
-  void drawTextBold(const String& s, int x, int y, uint16_t fg, uint16_t bg, int px, uint8_t datum){
+  void drawTextBold(const char* s, int x, int y, uint16_t fg, uint16_t bg, int px, uint8_t datum){
     drawText(s, x,   y,   fg, bg, px, datum);
     drawText(s, x+1, y,   fg, bg, px, datum);
     drawText(s, x,   y+1, fg, bg, px, datum);
@@ -164,13 +86,13 @@ namespace {
   }
 
   void drawStatic() {
-    layout();
     tft.fillScreen(COL_BG);
     // No inner card: draw directly on background for maximum usable space
 
     // Header title centered + divider
     useHeaderFont();
     drawTextBold("ProtoEtch", ui.cardX + ui.cardW/2, ui.titleY, COL_ORANGE, COL_BG, ui.hdrPx, TC_DATUM);
+    drawTankLabel();
     tft.drawLine(ui.cardX + ui.margin/3, ui.dividerY, ui.cardX + ui.cardW - ui.margin/3, ui.dividerY, COL_SILVER);
     
     // Section headers + static labels
@@ -193,8 +115,7 @@ namespace {
     // No divider above the action area (more breathing room for the button)
 
     // Buttons (fixed size from layout, precise vertical centering)
-    const int r = ui.W * 0.03;
-    tft.fillRoundRect(ui.btnX, ui.btnY, ui.btnW, ui.btnH, r, COL_ORANGE);
+    tft.fillRoundRect(ui.btnX, ui.btnY, ui.btnW, ui.btnH, ui.radius, COL_ORANGE);
     useButtonFont();
     tft.setTextDatum(MC_DATUM); // middle-center for exact centering
     tft.setTextColor(COL_WHITE, COL_ORANGE);
@@ -227,6 +148,17 @@ namespace {
     tft.fillRect(x, y0, w, h, COL_BG);
   }
 
+  // Right-aligned numeric value from the glyph atlas. The block covers the
+  // whole value column, so it also erases the previous value: one push.
+  void drawAtlasValue(int y, const char* s, int16_t& lastW){
+    const int16_t base = ui.valueX - ui.valueLeftX;
+    const int16_t tw   = GlyphAtlas::width(s);
+    const int16_t need = max(base, tw);
+    const int16_t w    = min(max(need, lastW), GlyphAtlas::maxWidth());
+    lastW = need;
+    tft.pushImage(ui.valueX - w, y, w, GlyphAtlas::height(), GlyphAtlas::compose(s, w));
+  }
+
   // Simple status icons (WiFi bars, MQTT three dots)
   void drawWifiIcon(int x, int y, bool ok){
     uint16_t c = ok ? COL_ORANGE : COL_SILVER;
@@ -270,6 +202,194 @@ namespace {
     int16_t y = ui.timeValueY - ui.lineH;
     tft.fillRect(x, y, w, h, COL_BG);
   }
+
+  /* ---------- Trend chart (hardware vertical scroll) ----------
+   * In landscape the panel's native row axis runs along screen X, so the
+   * controller's vertical scroll moves columns: the TREND_AXIS_W axis
+   * columns are a fixed area, the rest is a circular column buffer. A new
+   * sample overwrites the oldest column in panel memory and VSCRSADD is
+   * stepped by one so it appears at the right edge. In rotation 3 the
+   * panel rows run right-to-left (axis on the right), so the step is
+   * reversed. */
+  constexpr uint8_t CMD_VSCRDEF  = 0x33;  // ILI9341 / ST7789: scroll area definition
+  constexpr uint8_t CMD_VSCRSADD = 0x37;  // ILI9341 / ST7789: scroll start address
+  constexpr int16_t TREND_AXIS_W  = UiLayout::TREND_AXIS_W;     // fixed axis strip
+  constexpr int16_t TREND_COLS    = ui.trendCols;               // one sample per column
+  constexpr int16_t TREND_RELAY_H = 6;                          // relay strip height
+  constexpr int16_t TREND_NONE    = INT16_MIN;                  // gap marker
+
+  struct TrendSample {
+    int16_t tC10;          // bath temperature, 0.1 °C (TREND_NONE = invalid)
+    int16_t loC10, hiC10;  // hysteresis band, 0.1 °C
+    bool    relay;
+  };
+
+  struct Trend {
+    TrendSample buf[TREND_COLS];
+    uint16_t    count  = 0;      // valid samples in buf
+    uint16_t    next   = 0;      // ring write index
+    bool        shown  = false;
+    int16_t     head   = 0;      // scroll-area column receiving the next sample
+    int16_t     vsp    = 0;      // current VSCRSADD value
+    int16_t     prevY  = -1;     // trace row of the previous column (-1 = gap)
+    int16_t     centreC10 = 0;   // setpoint the vertical range is centred on
+  } trend;
+
+  void scrollDefine(uint16_t tfa, uint16_t vsa, uint16_t bfa) {
+    tft.writecommand(CMD_VSCRDEF);
+    tft.writedata(tfa >> 8); tft.writedata(tfa & 0xFF);
+    tft.writedata(vsa >> 8); tft.writedata(vsa & 0xFF);
+    tft.writedata(bfa >> 8); tft.writedata(bfa & 0xFF);
+  }
+  void scrollTo(uint16_t vsp) {
+    tft.writecommand(CMD_VSCRSADD);
+    tft.writedata(vsp >> 8); tft.writedata(vsp & 0xFF);
+  }
+
+  // Chart rows: [0, chartH) for the trace, relay strip at the bottom
+  inline int16_t trendChartH() { return ui.H - TREND_RELAY_H - 2; }
+  int16_t trendY(int32_t c10) {
+    const int32_t span10 = (int32_t)(TREND_SPAN_C * 10);
+    const int32_t hi10   = trend.centreC10 + span10;
+    int32_t y = (hi10 - c10) * (trendChartH() - 1) / (2 * span10);
+    if (y < 0) y = 0;
+    if (y > trendChartH() - 1) y = trendChartH() - 1;
+    return (int16_t)y;
+  }
+
+  // Render one sample into a column buffer and push it as a single
+  // 1 x H window, then optionally advance the hardware scroll.
+  void trendColumn(const TrendSample* s, bool scroll) {
+    static uint16_t col[TFT_WIDTH];
+    const int16_t H = ui.H < TFT_WIDTH ? ui.H : TFT_WIDTH;
+    const int16_t chartH = trendChartH();
+    for (int16_t y = 0; y < H; ++y) col[y] = COL_BG;
+
+    if (s) {
+      for (int16_t y = trendY(s->hiC10); y <= trendY(s->loC10); ++y) col[y] = COL_CARD;
+    }
+    // Grid every 5 °C
+    const int32_t span10 = (int32_t)(TREND_SPAN_C * 10);
+    for (int32_t g = ((trend.centreC10 - span10) / 50 + 1) * 50; g < trend.centreC10 + span10; g += 50) {
+      col[trendY(g)] = COL_GRID;
+    }
+    if (s && s->tC10 != TREND_NONE) {
+      // Join to the previous point so steep edges stay continuous
+      const int16_t y  = trendY(s->tC10);
+      const int16_t y0 = trend.prevY >= 0 ? trend.prevY : y;
+      for (int16_t k = min(y, y0); k <= max(y, y0); ++k) col[k] = COL_WHITE;
+      trend.prevY = y;
+    } else {
+      trend.prevY = -1;
+    }
+    const uint16_t relayCol = (s && s->relay) ? COL_ORANGE : COL_CARD;
+    for (int16_t y = chartH + 2; y < H; ++y) col[y] = relayCol;
+
+    const bool swap = tft.getSwapBytes();
+    tft.setSwapBytes(true);
+    const int16_t row = TREND_AXIS_W + trend.head;          // panel memory row
+    tft.pushImage(ui.trendMirror ? ui.W - 1 - row : row, 0, 1, H, col);
+    tft.setSwapBytes(swap);
+
+    if (ui.trendMirror) {
+      trend.vsp  = row;                                     // newest on the first scroll row
+      trend.head = (trend.head + TREND_COLS - 1) % TREND_COLS;
+    } else {
+      trend.head = (trend.head + 1) % TREND_COLS;
+      trend.vsp  = TREND_AXIS_W + trend.head;               // oldest on the first scroll row
+    }
+    if (scroll) scrollTo(trend.vsp);
+  }
+
+  void trendAxis() {
+    const int16_t x0 = ui.trendAxisX;
+    tft.fillRect(x0, 0, TREND_AXIS_W, ui.H, COL_BG);
+    tft.setTextFont(1);
+    tft.setTextDatum(ui.trendMirror ? ML_DATUM : MR_DATUM);
+    tft.setTextColor(COL_SILVER, COL_BG);
+    const int32_t span10 = (int32_t)(TREND_SPAN_C * 10);
+    for (int32_t g = ((trend.centreC10 - span10) / 50 + 1) * 50; g < trend.centreC10 + span10; g += 50) {
+      char buf[8];
+      snprintf(buf, sizeof(buf), "%ld", (long)(g / 10));
+      tft.drawString(buf, ui.trendMirror ? x0 + 4 : x0 + TREND_AXIS_W - 4, trendY(g));
+    }
+    tft.drawFastVLine(ui.trendMirror ? x0 : x0 + TREND_AXIS_W - 1, 0, trendChartH(), COL_SILVER);
+  }
+
+  /* ---------- Backlight + panel power ---------- */
+  constexpr uint8_t CMD_SLPIN   = 0x10;
+  constexpr uint8_t CMD_SLPOUT  = 0x11;
+  constexpr uint8_t CMD_DISPOFF = 0x28;
+  constexpr uint8_t CMD_DISPON  = 0x29;
+
+  enum class Pwr : uint8_t { Active, Dimmed, Asleep };
+  struct PowerState {
+    Pwr        state        = Pwr::Active;
+    uint64_t   lastActivity = 0;
+    Timers::Id idleTimer    = Timers::NONE;
+  } pwr;
+
+  // A lit backlight is a running LEDC output: no light sleep until it is off
+  void backlight(uint8_t duty){
+#ifdef TFT_BL
+    static bool lit = false;
+    ledcWrite(UI_BL_LEDC_CH, TFT_BACKLIGHT_ON ? duty : (uint8_t)(255 - duty));
+    if (duty && !lit) Power::acquire(Power::Lock::Backlight);
+    if (!duty && lit) Power::release(Power::Lock::Backlight);
+    lit = duty > 0;
+#endif
+  }
+
+  // Idle timer: dim, then sleep once the idle period has passed. Activity
+  // while dimmed re-arms the dim delay, so an early tick re-arms itself for
+  // whatever is left until the next step.
+  void powerTick(void*){
+    pwr.idleTimer = Timers::NONE;
+    const uint64_t now  = Timers::nowMs();
+    const uint64_t idle = now - pwr.lastActivity;
+    if (pwr.state == Pwr::Active && idle < UI_DIM_AFTER_MS) {
+      pwr.idleTimer = Timers::after(Timers::remaining(pwr.lastActivity, UI_DIM_AFTER_MS, now), powerTick);
+    } else if (pwr.state == Pwr::Active) {
+      backlight(UI_BL_DIM);
+      pwr.state = Pwr::Dimmed;
+      pwr.idleTimer = Timers::after(Timers::remaining(pwr.lastActivity, UI_SLEEP_AFTER_MS, now), powerTick);
+    } else if (pwr.state == Pwr::Dimmed && idle < UI_SLEEP_AFTER_MS) {
+      pwr.idleTimer = Timers::after(Timers::remaining(pwr.lastActivity, UI_SLEEP_AFTER_MS, now), powerTick);
+    } else if (pwr.state == Pwr::Dimmed) {
+      backlight(0);
+      tft.writecommand(CMD_DISPOFF);
+      tft.writecommand(CMD_SLPIN);   // panel RAM is retained
+      pwr.state = Pwr::Asleep;
+      LOGI("[UI] Panel asleep\n");
+    }
+  }
+
+  // Activity: restart the dim/sleep countdown
+  void touch(){
+    pwr.lastActivity = Timers::nowMs();
+    Timers::cancel(pwr.idleTimer);
+    pwr.idleTimer = Timers::after(UI_DIM_AFTER_MS, powerTick);
+  }
+
+  // Full chart rebuild: only on entering the page or when the range moves.
+  void trendRedraw() {
+    const TrendSample* last = trend.count
+      ? &trend.buf[(trend.next + TREND_COLS - 1) % TREND_COLS] : nullptr;
+    trend.centreC10 = last ? (last->loC10 + last->hiC10) / 2
+                           : Temp::deci(Temp::fromC(HEATER_SETPOINT_C));
+    scrollDefine(TREND_AXIS_W, TREND_COLS, 0);
+    trend.head  = 0;
+    trend.vsp   = TREND_AXIS_W;
+    trend.prevY = -1;
+    scrollTo(trend.vsp);
+    trendAxis();
+    // Oldest sample ends up at the left edge once all columns are written
+    for (uint16_t i = trend.count; i < TREND_COLS; ++i) trendColumn(nullptr, false);
+    for (uint16_t i = 0; i < trend.count; ++i) {
+      trendColumn(&trend.buf[(trend.next + TREND_COLS - trend.count + i) % TREND_COLS], false);
+    }
+    scrollTo(trend.vsp);
+  }
 }
 
 namespace DisplayUI {
@@ -320,25 +440,69 @@ void splash() {
 
 void begin() {
   tft.init();
-  tft.setRotation(1); // Landscape 320x240
+  tft.setRotation(UI_ROTATION); // must match the compile-time layout table
 #ifdef TFT_BL
-  pinMode(TFT_BL, OUTPUT);
-  digitalWrite(TFT_BL, TFT_BACKLIGHT_ON);
+  ledcSetup(UI_BL_LEDC_CH, UI_BL_LEDC_HZ, 8);
+  ledcAttachPin(TFT_BL, UI_BL_LEDC_CH);
 #endif
+  backlight(UI_BL_FULL);
   tft.setTextWrap(false);
+  if (tft.width() != ui.W || tft.height() != ui.H) {
+    LOGE("[UI] Panel %dx%d does not match layout %dx%d\n", tft.width(), tft.height(), ui.W, ui.H);
+  }
+  useHeaderFont();
+  if (tft.fontHeight() != UiLayout::HDR_FONT_H) {
+    LOGW("[UI] Header font height %d, layout assumes %d\n", tft.fontHeight(), UiLayout::HDR_FONT_H);
+  }
+  // Value digits are pre-rendered once in the value font/colors
+  GlyphAtlas::begin(&FreeMonoBold9pt7b, COL_WHITE, COL_BG);
   // Splash first, then the main chrome
   splash();
   drawStatic();
+  touch();
 }
 
-void update(float tempC,
-            float setpointC,
+void wake() {
+  touch();
+  if (pwr.state == Pwr::Active) return;
+  if (pwr.state == Pwr::Asleep) {
+    Power::Hold boost(Power::Lock::Display);
+    tft.writecommand(CMD_SLPOUT);
+    delay(5);                        // SLPOUT -> next command
+    tft.writecommand(CMD_DISPON);
+    // Values (and a tank switch) changed while asleep were not drawn
+    cache.inited = false;
+    if (trend.shown) trendRedraw();
+    else             drawTankLabel();
+    LOGI("[UI] Panel awake\n");
+  }
+  backlight(UI_BL_FULL);
+  pwr.state = Pwr::Active;
+}
+
+bool asleep() { return pwr.state == Pwr::Asleep; }
+
+void update(Temp::Raw temp,
+            Temp::Raw setpoint,
             bool  heaterOn,
             bool  agitateOn,
+            bool  jobRunning,
             uint32_t timeRemainingSec,
             bool  wifiOk,
             bool  mqttOk) {
 
+  // A running job keeps the panel lit (full backlight, awake); otherwise
+  // dim / sleep when idle
+  if (jobRunning || timeRemainingSec) wake();
+  if (pwr.state == Pwr::Asleep) return;
+
+  // The trend page owns the whole panel while shown
+  if (trend.shown) return;
+
+  // Full CPU clock while pushing pixels; the steady-state path must not allocate
+  Power::Hold boost(Power::Lock::Display);
+  HeapWatch::Scope noAlloc;
+
   // Header status icons removed for now (space reserved for future use)
 
   // Heater block
@@ -355,15 +519,15 @@ void update(float tempC,
     }
 
     // Temp line (cur/goal on right) – compare integer rounding and validity
-    bool valid = !isnan(tempC);
-    int curI   = valid ? (int)lrintf(tempC) : 0;
-    int spI    = (int)lrintf(setpointC);
+    bool valid = temp != Temp::NONE;
+    int curI   = valid ? Temp::whole(temp) : 0;
+    int spI    = Temp::whole(setpoint);
     if (!cache.inited || cache.tempValid != valid || cache.curTempI != curI || cache.setpointI != spI) {
-      clearValueArea(ui.heaterTempsY);
       char buf[32];
-      if (valid) snprintf(buf, sizeof(buf), "%dC / %dC", curI, spI);
-      else       snprintf(buf, sizeof(buf), "--C / %dC", spI);
-      drawText(buf, ui.valueX, ui.heaterTempsY, COL_WHITE, COL_BG, ui.valuePxBig, TR_DATUM);
+      const char d = GlyphAtlas::DEG;
+      if (valid) snprintf(buf, sizeof(buf), "%d%cC / %d%cC", curI, d, spI, d);
+      else       snprintf(buf, sizeof(buf), "--%cC / %d%cC", d, spI, d);
+      drawAtlasValue(ui.heaterTempsY, buf, cache.tempW);
       cache.tempValid = valid;
       cache.curTempI  = curI;
       cache.setpointI = spI;
@@ -386,18 +550,68 @@ void update(float tempC,
 
   // Etch time (MM:SS) displayed in the Etch section
   {
-    useValueFont();
     uint32_t sec = timeRemainingSec;
     if (!cache.inited || cache.timeSec != sec) {
-      clearValueArea(ui.etchTimeY);
       uint32_t mm = sec / 60; uint32_t ss = sec % 60;
       char buf[32];
       snprintf(buf, sizeof(buf), "%02u:%02u", (unsigned)mm, (unsigned)ss);
-      drawText(buf, ui.valueX, ui.etchTimeY, COL_WHITE, COL_BG, ui.timePx, TR_DATUM);
+      drawAtlasValue(ui.etchTimeY, buf, cache.timeW);
       cache.timeSec = sec;
     }
   }
   cache.inited = true;
 }
 
+void trendSample(Temp::Raw temp, Temp::Raw setpoint, Temp::Raw band, bool heaterOn) {
+  TrendSample& smp = trend.buf[trend.next];
+  smp.tC10  = temp == Temp::NONE ? TREND_NONE : Temp::deci(temp);
+  smp.loC10 = Temp::deci(setpoint - band / 2);
+  smp.hiC10 = Temp::deci(setpoint + (band - band / 2));
+  smp.relay = heaterOn;
+  trend.next = (trend.next + 1) % TREND_COLS;
+  if (trend.count < TREND_COLS) trend.count++;
+
+  if (!trend.shown || pwr.state == Pwr::Asleep) return;
+  Power::Hold boost(Power::Lock::Display);
+  HeapWatch::Scope noAlloc;
+  if ((smp.loC10 + smp.hiC10) / 2 != trend.centreC10) trendRedraw();  // setpoint moved
+  else                                                 trendColumn(&smp, true);
+}
+
+void showTrend(bool on) {
+  if (on == trend.shown) return;
+  if (on && !ui.trendOk) {
+    LOGW("[UI] Trend chart needs a landscape rotation\n");
+    return;
+  }
+  trend.shown = on;
+  Power::Hold boost(Power::Lock::Display);
+  if (on) {
+    trendRedraw();
+  } else {
+    // Back to an unscrolled full-panel window and the status page
+    scrollDefine(0, TFT_HEIGHT, 0);
+    scrollTo(0);
+    drawStatic();
+    cache.inited = false;
+  }
+}
+
+bool trendShown() { return trend.shown; }
+
+void showTank(const char* name) {
+  if (name == tankLabel) return;
+  tankLabel   = name;
+  trend.count = 0;
+  trend.next  = 0;
+  if (pwr.state == Pwr::Asleep) return;   // drawn by wake()
+  Power::Hold boost(Power::Lock::Display);
+  if (trend.shown) {
+    trendRedraw();
+  } else {
+    drawTankLabel();
+    cache.inited = false;
+  }
+}
+
 } // namespace DisplayUI
@@ -1,5 +1,6 @@
 #pragma once
 #include <Arduino.h>
+#include "../temp_fixed.h"
 
 namespace DisplayUI {
 
@@ -14,26 +15,70 @@ void splash();
  */
 void begin();
 
+/**
+ * Register operator input or an alarm: restores full backlight and, if the
+ * panel was put to sleep, wakes it (SLPOUT) and redraws the dynamic values.
+ */
+void wake();
+
+/** True while the panel is in sleep mode (update() does no SPI traffic). */
+bool asleep();
+
 /**
  * Refresh the dynamic UI values without flicker.
  * The function only redraws fields whose values actually changed since
  * the last call (internal cache), minimizing overdraw and shimmer.
+ * A running job (jobRunning or etch time left) lights the panel as wake() does;
+ * with no job and no wake() the backlight dims after UI_DIM_AFTER_MS and the
+ * panel sleeps after UI_SLEEP_AFTER_MS (timer wheel, see Timers).
  *
  * Parameters
- * - tempC:          Current temperature in Celsius (NaN if invalid).
- * - setpointC:      Heater setpoint in Celsius.
+ * - temp:           Current temperature, 1/16 °C (Temp::NONE if invalid).
+ * - setpoint:       Heater setpoint, 1/16 °C.
  * - heaterOn:       Current heater state.
- * - agitateOn:      Agitation (pump) state.
+ * - agitateOn:      Agitation (pump) state, shown only: automatic runs
+ *                   (heating, mixing, idle pulses) do not keep the panel lit.
+ * - jobRunning:     Operator job (manual pump run, running profile).
  * - agitatePct:     Agitation power percentage [0..100].
  * - timeRemainingSec: Remaining etch time in seconds (renders as MM:SS).
  * - wifiOk/mqttOk:  Reserved for future status indicators (ignored today).
  */
-void update(float tempC,
-            float setpointC,
+void update(Temp::Raw temp,
+            Temp::Raw setpoint,
             bool  heaterOn,
             bool  agitateOn = false,
+            bool  jobRunning = false,
             uint32_t timeRemainingSec = 0,
             bool  wifiOk = false,
             bool  mqttOk = false);
 
+/**
+ * Record one trend-chart sample (call every TREND_SAMPLE_MS).
+ * Samples are kept in a fixed ring buffer, one per chart column. While the
+ * chart is shown, only the newest column is drawn and the panel's hardware
+ * vertical scroll (VSCRSADD) advances the rest, so one sample costs a single
+ * 1-pixel-wide column push instead of a full redraw.
+ *
+ * - temp:      Bath temperature, 1/16 °C (Temp::NONE leaves a gap in the trace).
+ * - setpoint:  Setpoint; with band drawn as the hysteresis band.
+ * - band:      Total hysteresis band width, 1/16 °C (split as in HeaterController).
+ * - heaterOn:  Relay state, drawn as a strip along the bottom edge.
+ */
+void trendSample(Temp::Raw temp, Temp::Raw setpoint, Temp::Raw band, bool heaterOn);
+
+/**
+ * Switch between the status page and the full-screen trend chart.
+ * Entering the chart replays the ring buffer once; leaving it resets the
+ * scroll window and redraws the status page.
+ */
+void showTrend(bool on);
+bool trendShown();
+
+/**
+ * Name of the tank the status page and trend chart show, drawn right in
+ * the header (nullptr = none, for a single tank). A new tank starts an
+ * empty trend chart, so one trace never mixes two baths.
+ */
+void showTank(const char* name);
+
 } // namespace DisplayUI
@@ -0,0 +1,115 @@
+// Glyph atlas for numeric value rendering (see glyph_atlas.h)
+#include "glyph_atlas.h"
+#include "../config.h"
+
+namespace {
+  constexpr char    GLYPHS[]    = "0123456789:-/ C";
+  constexpr uint8_t N_GLYPHS    = sizeof(GLYPHS) - 1 + 1;   // + degree sign
+  constexpr uint8_t DEG_IDX     = N_GLYPHS - 1;
+  constexpr int16_t CELL_MAX_W  = 16;
+  constexpr int16_t CELL_MAX_H  = 28;
+  constexpr int16_t LINE_MAX_W  = 200;
+
+  uint16_t cells[N_GLYPHS][CELL_MAX_W * CELL_MAX_H];   // row-major, panel byte order
+  uint8_t  cellW[N_GLYPHS];
+  int8_t   glyphOf[256];                               // char -> cell, -1 = blank
+  uint16_t line[LINE_MAX_W * CELL_MAX_H];
+  int16_t  cellH = 0;
+  int16_t  fullW = 0;
+  uint16_t bgSw  = 0;
+
+  inline uint16_t swap16(uint16_t c) { return (uint16_t)((c >> 8) | (c << 8)); }
+
+  // Blit one 1-bit GFX glyph into a cell with its baseline at `ascent`
+  void rasterize(const GFXfont* f, char ch, uint16_t* cell, int16_t w,
+                 int16_t ascent, uint16_t fgSw) {
+    const GFXglyph& g  = f->glyph[(uint8_t)ch - f->first];
+    const uint8_t*  bm = f->bitmap + g.bitmapOffset;
+    uint16_t bit = 0;
+    for (int16_t yy = 0; yy < g.height; ++yy) {
+      for (int16_t xx = 0; xx < g.width; ++xx, ++bit) {
+        if (!(bm[bit >> 3] & (0x80 >> (bit & 7)))) continue;
+        const int16_t px = g.xOffset + xx;
+        const int16_t py = ascent + g.yOffset + yy;
+        if (px >= 0 && px < w && py >= 0 && py < cellH) cell[py * w + px] = fgSw;
+      }
+    }
+  }
+
+  // GFX fonts are 7-bit; draw a small ring aligned with the digit tops
+  void rasterizeDegree(const GFXfont* f, uint16_t* cell, int16_t w,
+                       int16_t ascent, uint16_t fgSw) {
+    static const char* ring[] = { ".###.", "#...#", "#...#", "#...#", ".###." };
+    const GFXglyph& zero = f->glyph['0' - f->first];
+    const int16_t top = ascent + zero.yOffset;
+    for (int16_t r = 0; r < 5; ++r)
+      for (int16_t c = 0; c < 5 && c < w; ++c)
+        if (ring[r][c] == '#' && top + r < cellH) cell[(top + r) * w + c] = fgSw;
+  }
+}
+
+namespace GlyphAtlas {
+
+void begin(const GFXfont* font, uint16_t fg, uint16_t bg) {
+  // Same metrics TFT_eSPI uses for free-font datums
+  int16_t ascent = 0, descent = 0;
+  for (uint16_t c = 0; c <= font->last - font->first; ++c) {
+    const GFXglyph& g = font->glyph[c];
+    ascent  = max<int16_t>(ascent,  -g.yOffset);
+    descent = max<int16_t>(descent, g.height + g.yOffset);
+  }
+  cellH = min<int16_t>(ascent + descent, CELL_MAX_H);
+  fullW = min<int16_t>(font->glyph['0' - font->first].xAdvance, CELL_MAX_W);
+  if (ascent + descent > CELL_MAX_H) LOGW("[Atlas] Font taller than %d px, clipped\n", CELL_MAX_H);
+
+  const uint16_t fgSw = swap16(fg);
+  bgSw = swap16(bg);
+  memset(glyphOf, -1, sizeof(glyphOf));
+  for (uint8_t i = 0; i < N_GLYPHS; ++i) {
+    const char ch = (i == DEG_IDX) ? DEG : GLYPHS[i];
+    const int16_t w = (ch == ' ' || ch == DEG) ? fullW / 2 + 1 : fullW;
+    cellW[i] = (uint8_t)w;
+    glyphOf[(uint8_t)ch] = (int8_t)i;
+    for (int16_t k = 0; k < w * cellH; ++k) cells[i][k] = bgSw;
+    if (ch == DEG)      rasterizeDegree(font, cells[i], w, ascent, fgSw);
+    else if (ch != ' ') rasterize(font, ch, cells[i], w, ascent, fgSw);
+  }
+  LOGI("[Atlas] %u glyphs, cell %dx%d\n", (unsigned)N_GLYPHS, fullW, cellH);
+}
+
+int16_t height()   { return cellH; }
+int16_t maxWidth() { return LINE_MAX_W; }
+
+int16_t width(const char* s) {
+  int16_t w = 0;
+  for (; *s; ++s) {
+    const int8_t i = glyphOf[(uint8_t)*s];
+    w += (i >= 0) ? cellW[i] : fullW;
+  }
+  return w;
+}
+
+const uint16_t* compose(const char* s, int16_t fieldW) {
+  fieldW = constrain(fieldW, (int16_t)0, LINE_MAX_W);
+  const int16_t tw  = width(s);
+  int16_t       x   = fieldW - tw;              // right-aligned
+  // Left padding
+  for (int16_t r = 0; r < cellH; ++r)
+    for (int16_t k = 0; k < x && k < fieldW; ++k) line[r * fieldW + k] = bgSw;
+  // Glyph cells, copied row by row
+  for (; *s; ++s) {
+    const int8_t  i = glyphOf[(uint8_t)*s];
+    const int16_t w = (i >= 0) ? cellW[i] : fullW;
+    const int16_t k0 = x < 0 ? -x : 0;             // clip to the field
+    const int16_t k1 = min<int16_t>(w, fieldW - x);
+    for (int16_t r = 0; k1 > k0 && r < cellH; ++r) {
+      uint16_t* dst = &line[r * fieldW + x];
+      if (i >= 0) memcpy(dst + k0, &cells[i][r * w + k0], (k1 - k0) * sizeof(uint16_t));
+      else        for (int16_t k = k0; k < k1; ++k) dst[k] = bgSw;
+    }
+    x += w;
+  }
+  return line;
+}
+
+} // namespace GlyphAtlas
@@ -0,0 +1,39 @@
+#pragma once
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+
+/**
+ * Pre-rasterized glyph cells for numeric values.
+ *
+ * The digits, ':', '-', '/', ' ', 'C' and a degree sign are rendered once
+ * from a GFX font into RGB565 cells (already in panel byte order) for one
+ * fg/bg color pair. A value string is then composed by copying cell rows
+ * into a line buffer, and the caller pushes that buffer in one block, so a
+ * redraw costs a few memcpy's plus a single SPI burst regardless of digits.
+ */
+namespace GlyphAtlas {
+
+/** Degree sign as used in strings passed to compose() / width(). */
+constexpr char DEG = '\xB0';
+
+/** Rasterize the glyph set from `font` in the given colors. Call once. */
+void begin(const GFXfont* font, uint16_t fg, uint16_t bg);
+
+/** Cell height in pixels (font ascent + descent, matches TL/TR datum top). */
+int16_t height();
+
+/** Pixel width of `s` (digits are fixed-width; ' ' and DEG are half cells). */
+int16_t width(const char* s);
+
+/**
+ * Compose `s` right-aligned into a `fieldW` x height() block, left-padded
+ * with the background color. Characters outside the set render as blanks.
+ * Returns the internal line buffer (valid until the next call), ready for
+ * pushImage() with swap-bytes disabled.
+ */
+const uint16_t* compose(const char* s, int16_t fieldW);
+
+/** Widest field compose() accepts. */
+int16_t maxWidth();
+
+} // namespace GlyphAtlas
@@ -0,0 +1,174 @@
+#pragma once
+// Compile-time UI geometry
+//
+// Every coordinate of the status page is derived from the panel size at
+// compile time, one table per supported panel/rotation. No TFT_eSPI
+// dependency, so the geometry can be inspected and checked on any host.
+//
+// Supported panels: 240x320 native (ILI9341 and ST7789V from the README).
+// Rotation 1/3 → 320x240 landscape, 0/2 → 240x320 portrait.
+
+#include <stdint.h>
+
+namespace UiLayout {
+
+// Free-font metrics the layout depends on (TFT_eSPI fontHeight() = yAdvance)
+constexpr int16_t HDR_FONT_H   = 22;  // FreeSansBold9pt7b (headers, button)
+constexpr int16_t LABEL_FONT_H = 22;  // FreeSans9pt7b (row labels)
+constexpr int16_t VALUE_FONT_H = 18;  // FreeMonoBold9pt7b (values, glyph atlas)
+
+// Widest strings per row (FreeSans9pt7b labels, glyph-atlas values)
+constexpr int16_t LABEL_REMAINING_W = 91;   // "Remaining:"
+constexpr int16_t LABEL_TEMP_W      = 51;   // "Temp:"
+constexpr int16_t LABEL_STATE_W     = 47;   // "State:"
+constexpr int16_t VALUE_TIME_W      = 55;   // "00:00"
+constexpr int16_t VALUE_TEMPS_W     = 112;  // "100°C / 70°C"
+constexpr int16_t VALUE_STATE_W     = 33;   // "OFF"
+constexpr int16_t LABEL_VALUE_GAP   = 4;
+
+constexpr int16_t TREND_AXIS_W = 36;        // fixed axis strip of the trend chart
+
+struct Layout {
+  int16_t W,H, margin, radius, gap;
+  int16_t cardX, cardY, cardW, cardH;
+
+  // Columns
+  int16_t labelX, indentX, valueLeftX, valueX;
+
+  // Rows
+  int16_t titleY, dividerY; // top bar
+  // Heater block
+  int16_t heaterHdrY;
+  int16_t heaterStateY;
+  int16_t heaterTempsY; // current / goal
+  // Agitation block
+  int16_t agitHdrY;
+  int16_t agitStateY;
+
+  // Buttons
+  int16_t btnY, btnW, btnH, btnX;
+
+  // Time Remaining (now under Etch section)
+  int16_t timeLabelY, timeValueY; // legacy (bottom timer) not used
+
+  // Status (WiFi/MQTT)
+  int16_t statusY; // in header bar
+  int16_t statusRightX;
+
+  // Metrics
+  int16_t lineH, step, hdrPx, labelPx, valuePx, btnPx, timePx;
+  int16_t labelPxBig, valuePxBig; // for State/Temp/Power lines
+
+  // Etch section
+  int16_t etchHdrY;
+  int16_t etchTimeY;
+
+  // Trend chart (hardware scroll runs along X only in landscape)
+  bool    trendOk;      // chart available in this rotation
+  bool    trendMirror;  // panel rows run right-to-left (rotation 3)
+  int16_t trendAxisX;   // screen X of the fixed axis strip
+  int16_t trendCols;    // scrolling columns (one sample each)
+};
+
+// Screen-dependent geometry. Safe margins prevent bezel clipping.
+constexpr Layout make(int16_t W, int16_t H, uint8_t rotation) {
+  Layout l{};
+  l.W = W;
+  l.H = H;
+
+  l.margin = l.W * 0.025;  // shrink light border for more usable space
+  l.radius = l.W * 0.030;  // slightly tighter corners
+  l.gap    = l.H * 0.012;
+
+  l.cardX = l.margin;
+  l.cardY = l.margin;
+  l.cardW = l.W - 2*l.margin;
+  l.cardH = l.H - 2*l.margin;
+
+  // Typography
+  l.hdrPx      = l.H * 0.064; // section headers
+  l.labelPx    = l.H * 0.047; // uniform, iets kleiner
+  l.valuePx    = l.H * 0.047;
+  l.labelPxBig = l.labelPx;   // gelijkgetrokken
+  l.valuePxBig = l.valuePx;
+  l.btnPx      = l.H * 0.043; // kleinere knoptekst
+  l.timePx     = l.valuePx;   // timer gelijk aan values
+  l.lineH      = l.H * 0.074;
+  l.step       = l.H * 0.092; // row spacing
+
+  // Columns
+  l.labelX     = l.cardX + l.margin/2;
+  l.indentX    = l.labelX + (l.W * 0.08);          // indentation under section headers
+  l.valueX     = l.cardX + l.cardW - l.margin - (l.W * 0.09); // larger safe-right margin
+  l.valueLeftX = l.cardX + (l.cardW * 0.52);       // left edge of value-clear area
+
+  // Rows (sections)
+  l.titleY      = 2; // exactly 2px from top edge to top of text (TC_DATUM)
+  // Divider exactly 2px below bottom of the header font
+  l.dividerY    = l.titleY + HDR_FONT_H + 2;
+  l.statusY     = l.titleY; // align with title
+  l.statusRightX= l.cardX + l.cardW - l.margin;
+
+  // Etch rows
+  l.etchHdrY     = l.dividerY + (l.H * 0.05);
+  l.etchTimeY    = l.etchHdrY + l.step;
+
+  // Heater rows
+  l.heaterHdrY   = l.etchHdrY + 2*l.step;
+  l.heaterStateY = l.heaterHdrY + l.step;
+  l.heaterTempsY = l.heaterHdrY + 2*l.step;
+  // Agitation rows
+  l.agitHdrY     = l.heaterHdrY + 3*l.step;
+  l.agitStateY   = l.agitHdrY + l.step;
+
+  // Button (single, centered): bottom edge 8px above the screen edge
+  l.btnW   = (l.cardW * 0.38);
+  l.btnH   = l.H * 0.072 + 2; // +2 px taller
+  l.btnY   = l.H - 8 - l.btnH;
+  l.btnX   = l.cardX + (l.cardW - l.btnW)/2;
+  // legacy timer vars retained but unused for bottom timer
+  l.timeLabelY = l.btnY + l.btnH + (l.gap * 0.4);
+  l.timeValueY = l.btnY + l.btnH + (l.gap * 0.9);
+
+  // Trend chart: axis strip sits on panel rows 0..AXIS-1 (the scroll
+  // "top fixed area"), which is the left edge in rotation 1, right in 3.
+  const bool landscape = rotation & 1;
+  l.trendOk     = landscape;
+  l.trendMirror = rotation == 3;
+  l.trendAxisX  = l.trendMirror ? l.W - TREND_AXIS_W : 0;
+  l.trendCols   = landscape ? l.W - TREND_AXIS_W : 1;
+  return l;
+}
+
+// Overlap rules checked at compile time for every table.
+constexpr bool rowsFit(const Layout& l) {
+  return l.etchHdrY     >= l.dividerY + 1
+      && l.step         >= LABEL_FONT_H                 // rows don't overlap
+      && l.agitStateY + LABEL_FONT_H <= l.btnY          // last row clears the button
+      && l.btnY + l.btnH <= l.H;
+}
+constexpr bool columnsFit(const Layout& l) {
+  return l.indentX + LABEL_REMAINING_W + LABEL_VALUE_GAP <= l.valueX - VALUE_TIME_W
+      && l.indentX + LABEL_TEMP_W      + LABEL_VALUE_GAP <= l.valueX - VALUE_TEMPS_W
+      && l.indentX + LABEL_STATE_W     + LABEL_VALUE_GAP <= l.valueX - VALUE_STATE_W
+      && l.valueX <= l.cardX + l.cardW;
+}
+
+/** Table for a 240x320-native panel in the given rotation (0..3). */
+template <uint8_t Rotation>
+constexpr Layout forRotation() {
+  static_assert(Rotation < 4, "rotation must be 0..3");
+  return make((Rotation & 1) ? 320 : 240, (Rotation & 1) ? 240 : 320, Rotation);
+}
+
+constexpr Layout LANDSCAPE   = forRotation<1>();
+constexpr Layout LANDSCAPE_R = forRotation<3>();
+constexpr Layout PORTRAIT    = forRotation<0>();
+constexpr Layout PORTRAIT_R  = forRotation<2>();
+
+static_assert(rowsFit(LANDSCAPE)   && columnsFit(LANDSCAPE),   "landscape layout overlaps");
+static_assert(rowsFit(LANDSCAPE_R) && columnsFit(LANDSCAPE_R), "landscape layout overlaps");
+static_assert(rowsFit(PORTRAIT)    && columnsFit(PORTRAIT),    "portrait layout overlaps");
+static_assert(rowsFit(PORTRAIT_R)  && columnsFit(PORTRAIT_R),  "portrait layout overlaps");
+
+} // namespace UiLayout
@@ -0,0 +1,381 @@
+// Host simulator for fleet load coordination (src/fleet_arbiter.*)
+//
+// Runs several simulated stations, each with its own FleetArbiter, a bath
+// model and the firmware's bang-bang heater rules (hysteresis, min-on/off),
+// and checks that the aggregate draw on the shared circuit never exceeds the
+// breaker rating. Claims travel over an in-process bus (latency, loss) or
+// over a real MQTT broker, on the topics and payloads the firmware uses.
+//
+//   g++ -std=c++17 -O2 -Isrc tools/fleet_sim/fleet_sim.cpp src/fleet_arbiter.cpp -o fleet_sim
+//   ./fleet_sim                                   # in-process bus
+//   mosquitto &                                   # or any local broker
+//   ./fleet_sim --broker 127.0.0.1 --speed 10
+//   mosquitto_sub -v -t 'protoetch/fleet/load/#'  # watch the claims
+//
+// A real station joins the same run when built with FLEET_ENABLE=1 and the
+// same FLEET_TOPIC / FLEET_BREAKER_W. Exit status 1 if the breaker rating
+// was exceeded.
+
+#include "fleet_arbiter.h"
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <memory>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Options {
+  int         stations  = 6;
+  int         breakerW  = 3600;
+  int         heaterW   = 800;
+  int         pumpW     = 30;
+  double      minutes   = 40;
+  double      setpointC = 45;
+  double      hystC     = 0.8;
+  const char* broker    = nullptr;
+  int         port      = 1883;
+  const char* topic     = "protoetch/fleet";
+  double      speed     = 10;    // simulated seconds per wall second (broker mode)
+  int         latencyMs = 50;    // in-process bus
+  double      loss      = 0.0;   // in-process bus, per delivery (stress only: QoS 0 over
+                                 // TCP does not drop within a session)
+  unsigned    seed      = 1;
+  bool        verbose   = false;
+};
+
+// Same defaults as config.h
+constexpr uint32_t STEP_MS    = 100;     // CTRL_PERIOD_MS
+constexpr uint32_t REFRESH_MS = 5000;    // FLEET_REFRESH_MS
+constexpr uint32_t MIN_ON_MS  = 15000;   // HEATER_MIN_ON_MS
+constexpr uint32_t MIN_OFF_MS = 15000;   // HEATER_MIN_OFF_MS
+
+// ---------------------------------------------------------------------------
+// Minimal MQTT 3.1.1 client: QoS 0 publish/subscribe, retained, last will
+// ---------------------------------------------------------------------------
+class Mqtt {
+public:
+  ~Mqtt() { if (fd_ >= 0) close(fd_); }
+
+  bool connect(const char* host, int port, const char* clientId,
+               const std::string& willTopic, const std::string& will) {
+    addrinfo hints{}, *res = nullptr;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(host, std::to_string(port).c_str(), &hints, &res) || !res) return false;
+    fd_ = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+    const bool ok = fd_ >= 0 && ::connect(fd_, res->ai_addr, res->ai_addrlen) == 0;
+    freeaddrinfo(res);
+    if (!ok) return false;
+
+    std::string p;
+    str(p, "MQTT");
+    p += '\x04';                                   // protocol level 3.1.1
+    p += (char)(0x02 | 0x04 | 0x20);               // clean session, will, will retain
+    p += '\x00'; p += (char)KEEPALIVE_S;
+    str(p, clientId);
+    str(p, willTopic);
+    str(p, will);
+    if (!send(0x10, p)) return false;
+
+    // CONNACK: 20 02 <flags> <rc>
+    uint8_t ack[4];
+    size_t  got = 0;
+    while (got < sizeof ack) {
+      const ssize_t r = recv(fd_, ack + got, sizeof ack - got, 0);
+      if (r <= 0) return false;
+      got += (size_t)r;
+    }
+    lastTx_ = now();
+    return ack[0] == 0x20 && ack[3] == 0;
+  }
+
+  bool subscribe(const std::string& filter) {
+    std::string p;
+    p += '\x00'; p += '\x01';                      // packet id
+    str(p, filter);
+    p += '\x00';                                   // QoS 0
+    return send(0x82, p);
+  }
+
+  bool publish(const std::string& topic, const std::string& payload, bool retain) {
+    std::string p;
+    str(p, topic);
+    p += payload;
+    return send(0x30 | (retain ? 1 : 0), p);
+  }
+
+  void disconnect() { send(0xE0, std::string()); }
+
+  // Read what arrived and hand each PUBLISH to cb(topic, payload)
+  template <typename Cb> bool poll(Cb cb) {
+    if (now() - lastTx_ > KEEPALIVE_S * 500) send(0xC0, std::string());
+    char buf[2048];
+    for (;;) {
+      const ssize_t r = recv(fd_, buf, sizeof buf, MSG_DONTWAIT);
+      if (r == 0) return false;
+      if (r < 0) break;
+      rx_.append(buf, (size_t)r);
+    }
+    for (;;) {
+      size_t len = 0, pos = 1;
+      int    shift = 0;
+      for (;; ++pos, shift += 7) {
+        if (pos >= rx_.size()) return true;
+        len |= (size_t)(rx_[pos] & 0x7F) << shift;
+        if (!(rx_[pos] & 0x80)) break;
+      }
+      ++pos;
+      if (rx_.size() < pos + len) return true;
+      const uint8_t type = (uint8_t)rx_[0] >> 4;
+      if (type == 3 && len >= 2) {
+        const size_t tl    = ((uint8_t)rx_[pos] << 8) | (uint8_t)rx_[pos + 1];
+        const size_t qosId = ((uint8_t)rx_[0] & 0x06) ? 2 : 0;
+        if (2 + tl + qosId <= len) {
+          cb(rx_.substr(pos + 2, tl), rx_.substr(pos + 2 + tl + qosId, len - 2 - tl - qosId));
+        }
+      }
+      rx_.erase(0, pos + len);
+    }
+  }
+
+private:
+  static constexpr int KEEPALIVE_S = 30;
+
+  static int64_t now() {
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+  }
+
+  static void str(std::string& p, const std::string& s) {
+    p += (char)(s.size() >> 8);
+    p += (char)(s.size() & 0xFF);
+    p += s;
+  }
+
+  bool send(uint8_t header, const std::string& body) {
+    std::string pkt(1, (char)header);
+    size_t len = body.size();
+    do {
+      uint8_t b = len & 0x7F;
+      len >>= 7;
+      if (len) b |= 0x80;
+      pkt += (char)b;
+    } while (len);
+    pkt += body;
+    lastTx_ = now();
+    return ::send(fd_, pkt.data(), pkt.size(), MSG_NOSIGNAL) == (ssize_t)pkt.size();
+  }
+
+  int         fd_     = -1;
+  int64_t     lastTx_ = 0;
+  std::string rx_;
+};
+
+// ---------------------------------------------------------------------------
+// Station: bath + heater rules + arbiter
+// ---------------------------------------------------------------------------
+struct Station {
+  Station(const char* id, const FleetArbiter::Policy& p) : arb(id, p) {}
+
+  FleetArbiter arb;
+  double       tempC       = 20;
+  bool         on          = false;
+  uint64_t     lastSwitch  = 0;
+  uint64_t     lastPub     = 0;
+  uint64_t     reachedMs   = 0;
+  uint64_t     heatedMs    = 0;
+  std::unique_ptr<Mqtt> link;
+
+  // HeaterController::wantsHeat()
+  bool wants(const Options& o) const {
+    return on ? tempC <= o.setpointC + o.hystC / 2 : tempC < o.setpointC - o.hystC / 2;
+  }
+
+  // HeaterController::tick(): min-on / min-off holds win over the grant
+  void tick(const Options& o, bool granted, uint64_t now) {
+    const bool want = granted && wants(o);
+    if (!on && want && now - lastSwitch >= MIN_OFF_MS)  { on = true;  lastSwitch = now; }
+    if (on && !want && now - lastSwitch >= MIN_ON_MS)   { on = false; lastSwitch = now; }
+  }
+};
+
+struct BusMsg {
+  uint64_t    at;
+  int         to;
+  std::string from, payload;
+};
+
+void usage() {
+  fprintf(stderr,
+    "fleet_sim [--stations N] [--breaker W] [--heater W] [--pump W] [--minutes M]\n"
+    "          [--setpoint C] [--broker HOST] [--port P] [--topic T] [--speed X]\n"
+    "          [--latency MS] [--loss P] [--seed S] [--verbose]\n");
+  exit(2);
+}
+
+Options parseArgs(int argc, char** argv) {
+  Options o;
+  for (int i = 1; i < argc; ++i) {
+    const std::string a = argv[i];
+    if (a == "--verbose") { o.verbose = true; continue; }
+    if (i + 1 >= argc) usage();
+    const char* v = argv[++i];
+    if      (a == "--stations") o.stations  = atoi(v);
+    else if (a == "--breaker")  o.breakerW  = atoi(v);
+    else if (a == "--heater")   o.heaterW   = atoi(v);
+    else if (a == "--pump")     o.pumpW     = atoi(v);
+    else if (a == "--minutes")  o.minutes   = atof(v);
+    else if (a == "--setpoint") o.setpointC = atof(v);
+    else if (a == "--broker")   o.broker    = v;
+    else if (a == "--port")     o.port      = atoi(v);
+    else if (a == "--topic")    o.topic     = v;
+    else if (a == "--speed")    o.speed     = atof(v);
+    else if (a == "--latency")  o.latencyMs = atoi(v);
+    else if (a == "--loss")     o.loss      = atof(v);
+    else if (a == "--seed")     o.seed      = (unsigned)atoi(v);
+    else usage();
+  }
+  if (o.stations < 1 || o.stations > FleetArbiter::MAX_PEERS + 1 || o.speed <= 0) usage();
+  return o;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const Options o = parseArgs(argc, argv);
+  const FleetArbiter::Policy policy = {
+    (uint16_t)o.breakerW, 3000, 60000, 15000, 0.5f, 0   // FLEET_* / POWER_SLICE_MS defaults
+  };
+
+  // Bath: ~5 l of etchant (≈ water), lid on; stations start from different temperatures
+  constexpr double HEAT_CAP_J_K = 21000;
+  constexpr double LOSS_W_K     = 8;
+  constexpr double AMBIENT_C    = 20;
+
+  std::mt19937 rng(o.seed);
+  std::uniform_real_distribution<double> uni(0, 1);
+  std::vector<std::unique_ptr<Station>> st;
+  const std::string loadTopic = std::string(o.topic) + "/load/";
+  for (int i = 0; i < o.stations; ++i) {
+    char id[FleetArbiter::ID_LEN];
+    snprintf(id, sizeof id, "sim-%02d", i);
+    st.emplace_back(new Station(id, policy));
+    st.back()->tempC = AMBIENT_C - 2 + 3 * i;
+  }
+
+  if (o.broker) {
+    char will[96];
+    FleetArbiter::format({ 0, 0, 0, (uint16_t)o.pumpW, 0, 0, 0 }, will, sizeof will);
+    for (auto& s : st) {
+      s->link.reset(new Mqtt);
+      const std::string self = loadTopic + s->arb.id();
+      if (!s->link->connect(o.broker, o.port, s->arb.id(), self, will)
+          || !s->link->subscribe(loadTopic + "+")) {
+        fprintf(stderr, "cannot reach broker %s:%d\n", o.broker, o.port);
+        return 2;
+      }
+      s->arb.setOnline(true, 0);
+    }
+  } else {
+    for (auto& s : st) s->arb.setOnline(true, 0);
+  }
+
+  std::vector<BusMsg> bus;
+  const uint64_t endMs = (uint64_t)(o.minutes * 60000);
+  uint64_t overMs = 0;
+  int      peakW  = 0;
+  const auto wall0 = std::chrono::steady_clock::now();
+
+  for (uint64_t now = 0; now <= endMs; now += STEP_MS) {
+    // 1) Deliver claims
+    if (o.broker) {
+      std::this_thread::sleep_until(wall0 + std::chrono::microseconds((int64_t)(now * 1000 / o.speed)));
+      for (auto& s : st) {
+        const bool up = s->link->poll([&](const std::string& topic, const std::string& payload) {
+          const size_t slash = topic.rfind('/');
+          s->arb.onPeer(topic.c_str() + slash + 1, payload.c_str(), now);
+        });
+        if (!up) { fprintf(stderr, "%s: broker closed the connection\n", s->arb.id()); return 2; }
+      }
+    } else {
+      for (size_t k = 0; k < bus.size();) {
+        if (bus[k].at > now) { ++k; continue; }
+        st[bus[k].to]->arb.onPeer(bus[k].from.c_str(), bus[k].payload.c_str(), now);
+        bus[k] = bus.back();
+        bus.pop_back();
+      }
+    }
+
+    // 2) Control tick per station: demand -> grant -> heater -> claim
+    int drawW = 0;
+    for (size_t i = 0; i < st.size(); ++i) {
+      Station& s = *st[i];
+      const bool want = s.wants(o);
+      FleetArbiter::Demand d{};
+      d.wantW = want ? o.heaterW : 0;
+      d.minW  = want ? o.heaterW : 0;
+      d.onW   = s.on ? o.heaterW : 0;
+      d.baseW = o.pumpW;
+      d.prio  = (float)(o.setpointC - s.tempC);
+      const uint16_t grant = s.arb.update(d, now);
+      s.tick(o, grant >= o.heaterW, now);
+
+      if (s.arb.dirty() || now - s.lastPub >= REFRESH_MS) {
+        char payload[96];
+        s.arb.claim(payload, sizeof payload, now);
+        s.lastPub = now;
+        if (o.broker) {
+          s.link->publish(loadTopic + s.arb.id(), payload, true);
+        } else {
+          for (size_t j = 0; j < st.size(); ++j) {
+            if (j == i || uni(rng) < o.loss) continue;
+            const uint64_t lat = (uint64_t)(o.latencyMs * (0.5 + uni(rng)));
+            bus.push_back({ now + lat, (int)j, s.arb.id(), payload });
+          }
+        }
+        if (o.verbose) printf("%7.1fs %s %s\n", now / 1000.0, s.arb.id(), payload);
+      }
+
+      // 3) Bath
+      const double p = s.on ? o.heaterW : 0;
+      s.tempC += (p - LOSS_W_K * (s.tempC - AMBIENT_C)) * (STEP_MS / 1000.0) / HEAT_CAP_J_K;
+      if (!s.reachedMs && s.tempC >= o.setpointC - o.hystC / 2) s.reachedMs = now;
+      if (s.on) s.heatedMs += STEP_MS;
+      drawW += (int)p + o.pumpW;
+    }
+
+    if (drawW > peakW) peakW = drawW;
+    if (drawW > o.breakerW) overMs += STEP_MS;
+    if (now % 60000 == 0) {
+      printf("%5.1f min %5d W |", now / 60000.0, drawW);
+      for (auto& s : st) printf(" %5.1f%c", s->tempC, s->on ? '*' : ' ');
+      printf("\n");
+    }
+  }
+
+  if (o.broker) {
+    for (auto& s : st) {
+      s->link->publish(loadTopic + s->arb.id(), "", true);   // clear the retained claims
+      s->link->disconnect();
+    }
+  }
+
+  printf("\nbreaker %d W, peak %d W, over the limit for %.1f s\n", o.breakerW, peakW, overMs / 1000.0);
+  for (auto& s : st) {
+    const FleetArbiter::Stats a = s->arb.stats();
+    printf("%s: %5.1f C, at setpoint after %5.1f min, heated %5.1f min, grants %u yields %u sheds %u peers %u\n",
+           s->arb.id(), s->tempC, s->reachedMs ? s->reachedMs / 60000.0 : -1.0, s->heatedMs / 60000.0,
+           (unsigned)a.grants, (unsigned)a.yields, (unsigned)a.sheds, (unsigned)a.peers);
+  }
+  return overMs ? 1 : 0;
+}
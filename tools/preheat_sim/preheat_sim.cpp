@@ -0,0 +1,163 @@
+// Host simulator for warm standby and scheduled preheat (src/standby_planner.*)
+//
+// Runs the planner against a simulated clock: a working week of shifts with
+// a bath model (heat capacity, losses to an ambient that is colder at
+// night, a lagging probe) and the firmware's bang-bang heater rules. The
+// operator is busy during each shift and leaves at its end; the bath drops
+// to standby after the idle time and must be back at the setpoint when the
+// next shift starts. Per shift it prints when the preheat began, the
+// learned warm-up rate and how far off the bath was at the start.
+//
+//   g++ -std=c++17 -O2 -Isrc tools/preheat_sim/preheat_sim.cpp src/standby_planner.cpp -o preheat_sim
+//   ./preheat_sim                       # Mon..Fri 07:30, rate guess 0.5 °C/min
+//   ./preheat_sim --rate-init 3 --heater 300 --litres 4
+//
+// Exit status 1 if the bath was more than --tolerance °C below the setpoint
+// at the start of the last shift (after the rate had been learned).
+
+#include "standby_planner.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+namespace {
+
+struct Options {
+  int    days       = 7;      // from Sunday 00:00
+  double setpointC  = 45;
+  double standbyC   = 30;
+  double hystC      = 0.8;
+  int    heaterW    = 500;
+  double litres     = 2;
+  double rateInit   = 0.5;    // °C/min, STANDBY_RATE_INIT_C_PER_MIN
+  int    shiftMin   = 7 * 60 + 30;
+  int    shiftHours = 8;
+  double tolerance  = 0.8;
+  bool   verbose    = false;
+};
+
+// Same defaults as config.h
+constexpr uint32_t STEP_MS    = 1000;
+constexpr uint32_t MIN_ON_MS  = 15000;    // HEATER_MIN_ON_MS
+constexpr uint32_t MIN_OFF_MS = 15000;    // HEATER_MIN_OFF_MS
+constexpr uint32_t IDLE_MS    = 1800000;  // STANDBY_IDLE_MS example
+constexpr uint32_t MARGIN_MS  = 600000;   // STANDBY_MARGIN_MS
+constexpr double   LOSS_W_K   = 4;        // open bath, small lid gap
+constexpr double   PROBE_TAU_S = 30;
+
+[[noreturn]] void usage() {
+  fprintf(stderr,
+          "usage: preheat_sim [--days N] [--setpoint C] [--standby C] [--heater W] [--litres L]\n"
+          "                   [--rate-init C/min] [--shift HH:MM] [--hours H] [--tolerance C] [--verbose]\n");
+  exit(2);
+}
+
+Options parseArgs(int argc, char** argv) {
+  Options o;
+  for (int i = 1; i < argc; ++i) {
+    const std::string a = argv[i];
+    if (a == "--verbose") { o.verbose = true; continue; }
+    if (i + 1 >= argc) usage();
+    const char* v = argv[++i];
+    if      (a == "--days")      o.days       = atoi(v);
+    else if (a == "--setpoint")  o.setpointC  = atof(v);
+    else if (a == "--standby")   o.standbyC   = atof(v);
+    else if (a == "--heater")    o.heaterW    = atoi(v);
+    else if (a == "--litres")    o.litres     = atof(v);
+    else if (a == "--rate-init") o.rateInit   = atof(v);
+    else if (a == "--hours")     o.shiftHours = atoi(v);
+    else if (a == "--tolerance") o.tolerance  = atof(v);
+    else if (a == "--shift") {
+      int h = 0, m = 0;
+      if (sscanf(v, "%d:%d", &h, &m) != 2) usage();
+      o.shiftMin = h * 60 + m;
+    }
+    else usage();
+  }
+  if (o.days < 1 || o.litres <= 0 || o.heaterW <= 0 || o.rateInit <= 0) usage();
+  return o;
+}
+
+// Workshop air: 16 °C before dawn, 22 °C mid-afternoon
+double ambientC(int32_t wallMin) {
+  const double h = (wallMin % (24 * 60)) / 60.0;
+  return 19 - 3 * cos((h - 3) / 24 * 2 * M_PI);
+}
+
+const char* clock(int32_t wallMin) {
+  static const char* DAY[] = { "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat" };
+  static char buf[16];
+  snprintf(buf, sizeof buf, "%s %02d:%02d", DAY[(wallMin / (24 * 60)) % 7], (wallMin / 60) % 24, wallMin % 60);
+  return buf;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const Options o = parseArgs(argc, argv);
+  const StandbyPlanner::Policy policy = {
+    (float)o.standbyC, IDLE_MS, MARGIN_MS, (float)o.rateInit, 0.3f, 3.0f
+  };
+  StandbyPlanner plan(policy, { 0x3E, (uint16_t)o.shiftMin });   // Mon..Fri
+
+  const double heatCapJK = o.litres * 4186;
+  double   bathC  = ambientC(0);
+  double   probeC = bathC;
+  bool     relay  = false;
+  uint64_t lastSwitch = 0;
+  StandbyPlanner::Mode lastMode = plan.mode();
+  uint64_t preheatMs = 0;
+  double   lastErr = NAN;
+  double   energyJ = 0;
+  int      shifts  = 0;
+
+  printf("shift start    preheat at     lead   rate °C/min  bath at start\n");
+  for (uint64_t now = 0; now < (uint64_t)o.days * 86400000ULL; now += STEP_MS) {
+    const int32_t wallMin = (int32_t)((now / 60000) % StandbyPlanner::MIN_PER_WEEK);
+    const int32_t dayMin  = wallMin % (24 * 60);
+    const bool    workday = (0x3E >> (wallMin / (24 * 60))) & 1;
+    const bool    inShift = workday && dayMin >= o.shiftMin && dayMin < o.shiftMin + o.shiftHours * 60;
+
+    plan.update(now, wallMin, (float)probeC, (float)o.setpointC, inShift);
+    const float ov = plan.overrideC();
+    const double sp = isnan(ov) ? o.setpointC : ov;
+
+    // HeaterController::wantsHeat() + min on/off holds
+    const bool want = relay ? probeC <= sp + o.hystC / 2 : probeC < sp - o.hystC / 2;
+    if (want != relay && now - lastSwitch >= (relay ? MIN_ON_MS : MIN_OFF_MS)) {
+      relay = want;
+      lastSwitch = now;
+    }
+    const double pW = relay ? o.heaterW : 0;
+    energyJ += pW * STEP_MS / 1000.0;
+    bathC  += (pW - LOSS_W_K * (bathC - ambientC(wallMin))) * (STEP_MS / 1000.0) / heatCapJK;
+    probeC += (bathC - probeC) * (STEP_MS / 1000.0) / PROBE_TAU_S;
+
+    if (plan.mode() != lastMode) {
+      if (o.verbose) printf("  %s  %s -> %s, bath %.1f °C\n", clock(wallMin),
+                            StandbyPlanner::name(lastMode), StandbyPlanner::name(plan.mode()), probeC);
+      if (plan.mode() == StandbyPlanner::Mode::Preheat) preheatMs = now;
+      lastMode = plan.mode();
+    }
+    if (workday && dayMin == o.shiftMin && now % 60000 == 0) {
+      shifts++;
+      lastErr = probeC - o.setpointC;
+      const int32_t pMin = (int32_t)((preheatMs / 60000) % StandbyPlanner::MIN_PER_WEEK);
+      char when[16];
+      snprintf(when, sizeof when, "%s", clock(pMin));
+      printf("%s  %s  %4.0f min  %5.2f        %.1f °C (%+.1f)\n", clock(wallMin),
+             preheatMs ? when : "-        ", preheatMs ? (now - preheatMs) / 60000.0 : 0.0,
+             plan.rateCPerMin(), probeC, lastErr);
+      preheatMs = 0;
+    }
+  }
+
+  const StandbyPlanner::Stats s = plan.stats();
+  printf("shifts %d, standbys %lu, preheats %lu, warm-ups learned %lu, heater energy %.2f kWh\n",
+         shifts, (unsigned long)s.standbys, (unsigned long)s.preheats, (unsigned long)s.learned,
+         energyJ / 3.6e6);
+  return shifts && lastErr < -o.tolerance ? 1 : 0;
+}